@@ -0,0 +1,230 @@
+#include "AdaptiveHuffman.hpp"
+
+#include <algorithm>
+#include <utility>
+
+// Constructor
+// pre: none
+// post: the tree is a single NYT leaf of weight 0, which is also the root
+AdaptiveHuffmanTree::AdaptiveHuffmanTree() {
+    nodes_.emplace_back();
+    order_.push_back(0);
+    root_ = nyt_ = 0;
+}
+
+// pre: none
+// post: returns the leaf holding 'word', or -1 if it was never added
+int AdaptiveHuffmanTree::leafOf(std::string_view word) const noexcept {
+    const auto it = leaves_.find(word);
+    return it == leaves_.end() ? -1 : it->second;
+}
+
+// Collects the code of a node by walking up to the root
+// pre: 'node' is a node of this tree
+// post: 'bits' holds the root-to-node path, '0' for left and '1' for right
+void AdaptiveHuffmanTree::codeOf(int node, std::string &bits) const {
+    bits.clear();
+    for (int n = node; nodes_[n].parent >= 0; n = nodes_[n].parent)
+        bits.push_back(nodes_[nodes_[n].parent].right == n ? '1' : '0');
+    std::reverse(bits.begin(), bits.end());
+}
+
+// Splits the NYT leaf into a new NYT (left) and a leaf for 'word' (right)
+// pre: 'word' has not been added yet
+// post: returns the new leaf, of weight 0; the old NYT is their internal parent,
+//       and both children rank right after it, the word leaf first
+int AdaptiveHuffmanTree::addSymbol(std::string_view word) {
+    const int parent = nyt_;
+    const int leaf = static_cast<int>(nodes_.size());
+    const int newNyt = leaf + 1;
+
+    Node symbol;
+    symbol.parent = parent;
+    symbol.rank = static_cast<int>(order_.size());
+    symbol.word = std::string(word);
+    nodes_.push_back(std::move(symbol));
+    order_.push_back(leaf);
+
+    Node escape;
+    escape.parent = parent;
+    escape.rank = static_cast<int>(order_.size());
+    nodes_.push_back(std::move(escape));
+    order_.push_back(newNyt);
+
+    nodes_[parent].left = newNyt;
+    nodes_[parent].right = leaf;
+    nyt_ = newNyt;
+    leaves_.emplace(nodes_[leaf].word, leaf);
+    return leaf;
+}
+
+// Highest-ranked node with the same weight as 'node' (FGK's block leader)
+// pre: order_[0..rank(node)] is sorted by non-increasing weight
+// post: returns the leader; it is 'node' itself if no other node qualifies
+int AdaptiveHuffmanTree::blockLeader(int node) const noexcept {
+    const std::uint64_t weight = nodes_[node].weight;
+    const auto end = order_.begin() + nodes_[node].rank + 1;
+    const auto it = std::partition_point(order_.begin(), end,
+                                         [&](int n) { return nodes_[n].weight > weight; });
+    return *it;
+}
+
+// Exchanges two subtrees and their ranks
+// pre: neither node is an ancestor of the other
+// post: 'a' sits where 'b' was in the tree and in order_, and vice versa
+void AdaptiveHuffmanTree::swapNodes(int a, int b) noexcept {
+    Node &na = nodes_[a];
+    Node &nb = nodes_[b];
+    if (na.parent == nb.parent) {
+        Node &p = nodes_[na.parent];
+        std::swap(p.left, p.right);
+    } else {
+        Node &pa = nodes_[na.parent];
+        Node &pb = nodes_[nb.parent];
+        (pa.left == a ? pa.left : pa.right) = b;
+        (pb.left == b ? pb.left : pb.right) = a;
+        std::swap(na.parent, nb.parent);
+    }
+    std::swap(order_[na.rank], order_[nb.rank]);
+    std::swap(na.rank, nb.rank);
+}
+
+// FGK update
+// pre: 'leaf' is a symbol leaf
+// post: the weights on the path from 'leaf' to the root went up by one; before
+//       each increment the node was swapped with its block leader (unless that
+//       is its parent), so order_ again has non-increasing weights
+void AdaptiveHuffmanTree::increment(int leaf) {
+    for (int node = leaf; node >= 0; node = nodes_[node].parent) {
+        const int leader = blockLeader(node);
+        if (leader != node && leader != nodes_[node].parent)
+            swapNodes(node, leader);
+        ++nodes_[node].weight;
+    }
+}
+
+// Constructor
+// pre: 'os' is open for writing; wrapCols > 0
+// post: encoder starts from the empty model at column 0
+AdaptiveHuffmanEncoder::AdaptiveHuffmanEncoder(std::ostream &os, int wrapCols)
+    : os_(os), wrap_(wrapCols > 0 ? static_cast<std::size_t>(wrapCols) : 80) {}
+
+// pre: none
+// post: writes one bit character, breaking the line after every wrap_ bits
+void AdaptiveHuffmanEncoder::put(char bit) {
+    os_.put(bit);
+    if (++column_ == wrap_) {
+        os_.put('\n');
+        column_ = 0;
+    }
+}
+
+// Encodes one token
+// pre: 'word' is non-empty and contains no NUL byte
+// post: the token's bits are written and the model counts it;
+//       returns FAILED_TO_WRITE_FILE if the stream failed
+error_type AdaptiveHuffmanEncoder::encode(std::string_view word) {
+    int leaf = tree_.leafOf(word);
+    if (leaf >= 0) {
+        tree_.codeOf(leaf, bits_);
+        for (char bit : bits_)
+            put(bit);
+    } else {
+        tree_.codeOf(tree_.nyt(), bits_);
+        for (char bit : bits_)
+            put(bit);
+        for (unsigned char c : word)
+            for (int i = 7; i >= 0; --i)
+                put((c >> i) & 1 ? '1' : '0');
+        for (int i = 0; i < 8; ++i)
+            put('0');
+        leaf = tree_.addSymbol(word);
+    }
+    tree_.increment(leaf);
+    return os_ ? NO_ERROR : FAILED_TO_WRITE_FILE;
+}
+
+// pre: none
+// post: a partial last line is terminated; returns FAILED_TO_WRITE_FILE if the stream failed
+error_type AdaptiveHuffmanEncoder::finish() {
+    if (column_ != 0) {
+        os_.put('\n');
+        column_ = 0;
+    }
+    os_.flush();
+    return os_ ? NO_ERROR : FAILED_TO_WRITE_FILE;
+}
+
+// Constructor
+// pre: 'is' is open for reading
+// post: decoder starts from the empty model
+AdaptiveHuffmanDecoder::AdaptiveHuffmanDecoder(std::istream &is) : is_(is) {}
+
+// pre: none
+// post: returns the next '0'/'1' as 0/1, skipping line breaks; -1 at end of input;
+//       any other character sets MALFORMED_CODE and returns -1
+int AdaptiveHuffmanDecoder::readBit() {
+    for (int c = is_.get(); c != std::istream::traits_type::eof(); c = is_.get()) {
+        if (c == '0' || c == '1')
+            return c - '0';
+        if (c != '\n' && c != '\r') {
+            status_ = MALFORMED_CODE;
+            return -1;
+        }
+    }
+    return -1;
+}
+
+// Decodes one token
+// pre: the input was written by AdaptiveHuffmanEncoder
+// post: returns true with 'word' set and the model updated; false at a clean end
+//       of input, or with status() FAILED_TO_READ_FILE if the input stops mid-token
+//       and MALFORMED_CODE if it holds anything but bits or an escape is empty
+bool AdaptiveHuffmanDecoder::next(std::string &word) {
+    if (status_ != NO_ERROR)
+        return false;
+
+    int node = tree_.root();
+    bool started = false;
+    while (!tree_.isLeaf(node)) {
+        const int bit = readBit();
+        if (bit < 0) {
+            if (started && status_ == NO_ERROR)
+                status_ = FAILED_TO_READ_FILE;
+            return false;
+        }
+        started = true;
+        node = tree_.child(node, bit == 1);
+    }
+
+    if (node != tree_.nyt()) {
+        word = tree_.word(node);
+        tree_.increment(node);
+        return true;
+    }
+
+    // NYT: the word follows as bytes up to a zero byte. With an empty model
+    // the NYT is the root and has no bits, so an empty stream ends here.
+    word.clear();
+    for (;;) {
+        int byte = 0;
+        for (int i = 0; i < 8; ++i) {
+            const int bit = readBit();
+            if (bit < 0) {
+                if ((started || i > 0 || !word.empty()) && status_ == NO_ERROR)
+                    status_ = FAILED_TO_READ_FILE;
+                return false;
+            }
+            byte = (byte << 1) | bit;
+        }
+        if (byte == 0)
+            break;
+        word.push_back(static_cast<char>(byte));
+    }
+    if (word.empty()) {
+        status_ = MALFORMED_CODE;   // an escape must carry at least one byte
+        return false;
+    }
+    tree_.increment(tree_.addSymbol(word));
+    return true;
+}
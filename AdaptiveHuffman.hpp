@@ -0,0 +1,107 @@
+#ifndef P3_PART1_ADAPTIVEHUFFMAN_H
+#define P3_PART1_ADAPTIVEHUFFMAN_H
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "utils.hpp"
+
+// Single-pass adaptive Huffman coding over words (FGK algorithm).
+//
+// Encoder and decoder start from the same one-leaf tree holding only the NYT
+// ("not yet transmitted") escape and update it identically after every token,
+// so no counts, header or lookahead are needed. A word seen before is sent as
+// its current code; a new word is sent as the NYT code followed by its bytes,
+// 8 bits each, most significant first, and a zero byte. The bit stream is
+// ASCII '0'/'1' wrapped at 80 columns, like the .code file.
+class AdaptiveHuffmanTree {
+public:
+    AdaptiveHuffmanTree();
+
+    // Leaf for 'word', or -1 if it has not been seen.
+    [[nodiscard]] int leafOf(std::string_view word) const noexcept;
+
+    // Code of 'node' from the root as '0'/'1' characters (empty for the root).
+    void codeOf(int node, std::string &bits) const;
+
+    // Add 'word' as a new symbol by splitting the NYT leaf; returns its leaf.
+    int addSymbol(std::string_view word);
+
+    // Count one more occurrence of 'leaf' and restore the sibling property.
+    void increment(int leaf);
+
+    [[nodiscard]] int root() const noexcept { return root_; }
+    [[nodiscard]] int nyt() const noexcept { return nyt_; }
+    [[nodiscard]] bool isLeaf(int node) const noexcept { return nodes_[node].left < 0; }
+    [[nodiscard]] int child(int node, bool one) const noexcept { return one ? nodes_[node].right : nodes_[node].left; }
+    [[nodiscard]] const std::string &word(int leaf) const noexcept { return nodes_[leaf].word; }
+
+private:
+    struct Node {
+        std::uint64_t weight = 0;
+        int parent = -1;
+        int left = -1;     // internal nodes have both children, leaves neither
+        int right = -1;
+        int rank = 0;      // position in order_
+        std::string word;  // leaves only
+    };
+
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<int> order_;   // nodes by rank; weights never increase along it (root first)
+    std::unordered_map<std::string, int, Hash, std::equal_to<>> leaves_;
+    int root_ = 0;
+    int nyt_ = 0;
+
+    int blockLeader(int node) const noexcept;
+    void swapNodes(int a, int b) noexcept;
+};
+
+class AdaptiveHuffmanEncoder {
+public:
+    explicit AdaptiveHuffmanEncoder(std::ostream &os, int wrapCols = 80);
+
+    // Encode one token and update the model.
+    error_type encode(std::string_view word);
+
+    // Terminate the last line. Call once after the final token.
+    error_type finish();
+
+private:
+    AdaptiveHuffmanTree tree_;
+    std::ostream &os_;
+    std::size_t wrap_;
+    std::size_t column_ = 0;
+    std::string bits_;   // scratch for the current token
+
+    void put(char bit);
+};
+
+class AdaptiveHuffmanDecoder {
+public:
+    explicit AdaptiveHuffmanDecoder(std::istream &is);
+
+    // Decode the next token; returns false at end of input or on error (see status()).
+    bool next(std::string &word);
+
+    [[nodiscard]] error_type status() const noexcept { return status_; }
+
+private:
+    AdaptiveHuffmanTree tree_;
+    std::istream &is_;
+    error_type status_ = NO_ERROR;
+
+    int readBit();   // 0, 1, or -1 at end of input
+};
+
+#endif //P3_PART1_ADAPTIVEHUFFMAN_H
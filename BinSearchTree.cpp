@@ -3,34 +3,25 @@
 //
 
 #include "BinSearchTree.hpp"
+#include <algorithm>
 #include <optional>
 
-BinSearchTree::~BinSearchTree() {destroy(root_); }
-
-// Deletes an entire subtree rooted at 'node'
-// pre: 'node' is either nullptr or a valid pointer to a TreeNode in this tree.
-// post: all nodes in the subtree are deleted; no leaf, children remain.
-void BinSearchTree::destroy(TreeNode *node) noexcept {
-    if (!node)
-        return;
-    destroy(node->left);
-    destroy(node->right);
-    delete node;
-}
-
 // Inserts 'word' into the BST subtree rooted at 'node'
-// if 'word' exists, increment frequency
-// pre: 'node' is either nullptr or the root of a valid BST subtree
-// post: Returns the root of the subtree with 'word' in it, frequency is incremented
-TreeNode *BinSearchTree::insertHelper(TreeNode *node, const std::string &word) {
-    if (!node)
-        return new TreeNode(word, 1);
-    if (word == node->word) {
-        node->freq += 1;
-    } else if (word < node->word) {
-        node->left = insertHelper(node->left, word);
+// if 'word' exists, add 'count' to its frequency
+// pre: 'node' is either kNull or the root of a valid BST subtree
+// post: Returns the root of the subtree with 'word' in it, frequency is increased by 'count'
+BinSearchTree::Index BinSearchTree::insertHelper(Index node, std::string_view word, std::uint64_t count) {
+    if (node == TreeNode::kNull)
+        return nodes_.add(word, count);
+    const std::string_view here = nodes_.word(node);
+    if (word == here) {
+        nodes_[node].freq += count;
+    } else if (word < here) {
+        const Index child = insertHelper(nodes_[node].left, word, count);   // may grow the arena
+        nodes_[node].left = child;
     } else {
-        node->right = insertHelper(node->right, word);
+        const Index child = insertHelper(nodes_[node].right, word, count);
+        nodes_[node].right = child;
     }
     return node;
 }
@@ -39,7 +30,15 @@ TreeNode *BinSearchTree::insertHelper(TreeNode *node, const std::string &word) {
 // pre: none
 // post: Tree contains 'word', if 'word' is present, frequency plus 1
 void BinSearchTree::insert(const std::string &word) {
-    root_ = insertHelper(root_, word);
+    root_ = insertHelper(root_, word, 1);
+}
+
+// Adds 'word' with a pre-counted frequency. Inserting distinct words in their
+// first-occurrence order yields the same tree shape as inserting every token.
+// pre: count > 0
+// post: Tree contains 'word', its frequency is increased by 'count'
+void BinSearchTree::insert(const std::string &word, std::uint64_t count) {
+    root_ = insertHelper(root_, word, count);
 }
 
 // Inserts all words from 'words' into the tree
@@ -49,77 +48,114 @@ void BinSearchTree::bulkInsert(const std::vector<std::string> &words) {
     for (const auto &word : words) insert(word);
 }
 
-// Iteratively seraches for 'word' starting at 'node'
-// pre: 'node' is either nullptr or the root of a valid BST subtree
-// post: returns pointer to the node with 'word' or nullptr if not found
-const TreeNode *BinSearchTree::findNode(const TreeNode *node, std::string_view word) noexcept {
-    while (node) {
-        if (word == node->word)
+// Iteratively seraches for 'word' starting at the root
+// pre: none
+// post: returns the node with 'word' or kNull if not found
+BinSearchTree::Index BinSearchTree::findNode(std::string_view word) const noexcept {
+    Index node = root_;
+    while (node != TreeNode::kNull) {
+        const std::string_view here = nodes_.word(node);
+        if (word == here)
             return node;
-        node = (word < node->word) ? node->left : node->right;
+        node = (word < here) ? nodes_[node].left : nodes_[node].right;
     }
-    return nullptr;
+    return TreeNode::kNull;
 }
 
 // Checks whether 'word' is present in the tree
 // pre: none
 // post: returns true if a node with 'word' exists
 bool BinSearchTree::contains(std::string_view word) const noexcept {
-    return findNode(root_, word) != nullptr;
+    return findNode(word) != TreeNode::kNull;
 }
 
 // Retrieves the frequency of 'word' if present
 // pre: none
 // post: returns frequency if found, else nullopt
-std::optional<int> BinSearchTree::countOf(std::string_view word) const noexcept {
-    if (auto* node = findNode(root_, word))
-        return node->freq;
+std::optional<std::uint64_t> BinSearchTree::countOf(std::string_view word) const noexcept {
+    if (Index node = findNode(word); node != TreeNode::kNull)
+        return nodes_[node].freq;
     return std::nullopt;
 }
 
 // In-order traversal appending word, freq to 'out'
-// pre: 'node' is nullptr or a valid subtree root, 'out' is a valid vector reference
+// pre: 'node' is kNull or a valid subtree root, 'out' is a valid vector reference
 // post: appends elements from this subtree to 'out' in ascending order by word
-void BinSearchTree::inorderHelper(const TreeNode *node, std::vector<std::pair<std::string, int> > &out) {
-    if (!node)
+void BinSearchTree::inorderHelper(Index node, std::vector<std::pair<std::string, std::uint64_t>> &out) const {
+    if (node == TreeNode::kNull)
         return;
-    inorderHelper(node->left, out);
-    out.push_back({node->word, node->freq});
-    inorderHelper(node->right, out);
+    inorderHelper(nodes_[node].left, out);
+    out.emplace_back(std::string(nodes_.word(node)), nodes_[node].freq);
+    inorderHelper(nodes_[node].right, out);
 }
 
 // Collects word, freq, from the whole tree in sorted order
 // pre: 'out' is a valid vector reference
 // post: 'out' is cleared and then filled with the entire tree's contents in ascdening order
-void BinSearchTree::inorderCollect(std::vector<std::pair<std::string, int> > &out) const {
+void BinSearchTree::inorderCollect(std::vector<std::pair<std::string, std::uint64_t>> &out) const {
     out.clear();
+    out.reserve(nodes_.size());
     inorderHelper(root_, out);
 }
 
-// Counts nodes in a subtree, unique words
-// pre: 'node' is nullptr of a valid subtree root
-// post: Returns the number of nodes in the subtree
-std::size_t BinSearchTree::sizeHelper(const TreeNode* node)  noexcept {
-    if (!node)
-        return 0;
-    return 1 + sizeHelper(node->left)+ sizeHelper(node->right);
+// Ranking order for top-k selection, higher count wins, tie by smaller word
+// pre: a and b are valid nodes
+// post: returns true if 'a' ranks before 'b'
+bool BinSearchTree::ranksBefore(Index a, Index b) const noexcept {
+    if (nodes_[a].freq != nodes_[b].freq)
+        return nodes_[a].freq > nodes_[b].freq;
+    return nodes_.word(a) < nodes_.word(b);
+}
+
+// Offers every node of a subtree to a bounded heap whose front is the worst kept node
+// pre: 'node' is kNull or a valid subtree root, k > 0, 'heap' holds at most k nodes
+// post: 'heap' holds the k best-ranked nodes seen so far
+void BinSearchTree::topKHelper(Index node, std::size_t k, std::vector<Index> &heap) const {
+    if (node == TreeNode::kNull)
+        return;
+    const auto ranksBefore = [this](Index a, Index b) { return this->ranksBefore(a, b); };
+    topKHelper(nodes_[node].left, k, heap);
+    if (heap.size() < k) {
+        heap.push_back(node);
+        std::push_heap(heap.begin(), heap.end(), ranksBefore);
+    } else if (ranksBefore(node, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), ranksBefore);
+        heap.back() = node;
+        std::push_heap(heap.begin(), heap.end(), ranksBefore);
+    }
+    topKHelper(nodes_[node].right, k, heap);
+}
+
+// Collects the k most frequent words
+// pre: 'out' is a valid vector reference
+// post: 'out' is cleared and filled with min(k, size()) (word, freq) pairs in ranking order
+void BinSearchTree::topK(std::size_t k, std::vector<std::pair<std::string, std::uint64_t>> &out) const {
+    out.clear();
+    if (k == 0)
+        return;
+    std::vector<Index> heap;
+    topKHelper(root_, k, heap);
+    std::sort_heap(heap.begin(), heap.end(), [this](Index a, Index b) { return ranksBefore(a, b); });
+    out.reserve(heap.size());
+    for (Index node : heap)
+        out.emplace_back(std::string(nodes_.word(node)), nodes_[node].freq);
 }
 
 // Returns the number of unique words in the tree
 // pre: none
-// post: returns size_t count
+// post: returns size_t count; every node in the arena is a distinct word
 std::size_t BinSearchTree::size() const noexcept {
-    return sizeHelper(root_);
+    return nodes_.size();
 }
 
 // Finds the height of a subtree in nodes
-// pre: 'node' is nullptr or a valid subtree root
+// pre: 'node' is kNull or a valid subtree root
 // post: returns the heigh as an unsigned int
-unsigned int BinSearchTree::heightHelper(const TreeNode* node) noexcept {
-    if (!node)
+unsigned int BinSearchTree::heightHelper(Index node) const noexcept {
+    if (node == TreeNode::kNull)
         return 0;
-    unsigned lh = heightHelper(node->left);
-    unsigned rh = heightHelper(node->right);
+    unsigned lh = heightHelper(nodes_[node].left);
+    unsigned rh = heightHelper(nodes_[node].right);
     return 1 + (lh > rh ? lh : rh);
 }
 
@@ -129,5 +165,3 @@ unsigned int BinSearchTree::heightHelper(const TreeNode* node) noexcept {
 unsigned BinSearchTree::height() const noexcept {
     return heightHelper(root_);
 }
-
-
@@ -5,7 +5,9 @@
 #ifndef P3_PART1_BINSEARCHTREE_H
 #define P3_PART1_BINSEARCHTREE_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include "TreeNode.hpp"
@@ -14,43 +16,53 @@ class BinSearchTree {
 public:
     BinSearchTree() = default;
 
-    ~BinSearchTree(); // calls destroy(root_)
-
     // Insert 'word'; if present, increment its count.
     void insert(const std::string &word);
 
+    // Insert 'word' with an already known count (added to any existing count).
+    void insert(const std::string &word, std::uint64_t count);
+
     // Convenience: loop over insert(word) for each token.
     void bulkInsert(const std::vector<std::string> &words);
 
     // Queries
     [[nodiscard]] bool contains(std::string_view word) const noexcept;
 
-    [[nodiscard]] std::optional<int> countOf(std::string_view word) const noexcept;
+    [[nodiscard]] std::optional<std::uint64_t> countOf(std::string_view word) const noexcept;
 
     // In-order traversal (word-lex order) -> flat list for next stage
-    void inorderCollect(std::vector<std::pair<std::string, int> > &out) const;
+    void inorderCollect(std::vector<std::pair<std::string, std::uint64_t>> &out) const;
+
+    // The k most frequent words in ranking order (count desc, word asc),
+    // selected with a bounded heap of k nodes: O(n log k) time, O(k) extra space.
+    void topK(std::size_t k, std::vector<std::pair<std::string, std::uint64_t>> &out) const;
 
     // Metrics
     [[nodiscard]] std::size_t size() const noexcept; // distinct words
     [[nodiscard]] unsigned height() const noexcept; // empty tree = 0
 
+    // Heap bytes held by the nodes and their words.
+    [[nodiscard]] std::size_t memoryBytes() const noexcept { return nodes_.bytes(); }
+
 private:
-    // TreeNode is defined elsewhere in the project
-    TreeNode *root_ = nullptr;
+    using Index = NodeArena::Index;
+
+    // Nodes and words live in the arena; children are indices into it.
+    NodeArena nodes_;
+    Index root_ = TreeNode::kNull;
 
     // Helpers
-    static void destroy(TreeNode *node) noexcept;
+    Index insertHelper(Index node, std::string_view word, std::uint64_t count);
 
-    static TreeNode *insertHelper(TreeNode *node, const std::string &word);
+    [[nodiscard]] Index findNode(std::string_view word) const noexcept;
 
-    static const TreeNode *findNode(const TreeNode *node, std::string_view word) noexcept;
+    void inorderHelper(Index node, std::vector<std::pair<std::string, std::uint64_t>> &out) const;
 
-    static void inorderHelper(const TreeNode *node,
-                              std::vector<std::pair<std::string, int> > &out);
+    [[nodiscard]] bool ranksBefore(Index a, Index b) const noexcept;
 
-    static std::size_t sizeHelper(const TreeNode *node) noexcept;
+    void topKHelper(Index node, std::size_t k, std::vector<Index> &heap) const;
 
-    static unsigned heightHelper(const TreeNode *node) noexcept;
+    [[nodiscard]] unsigned heightHelper(Index node) const noexcept;
 };
 
 #endif //P3_PART1_BINSEARCHTREE_H
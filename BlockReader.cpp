@@ -0,0 +1,275 @@
+#include "BlockReader.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef P3_HAVE_ZLIB
+#include <zlib.h>
+
+struct BlockReader::GzipState {
+    z_stream stream{};
+    std::vector<unsigned char> input = std::vector<unsigned char>(64 * 1024);
+    bool memberEnded = false;   // last inflate() finished a gzip member
+    bool initialized = false;
+
+    // pre: none
+    // post: returns inflateInit2's result; the stream is usable only on Z_OK
+    int init() {
+        const int rc = inflateInit2(&stream, 15 + 16);   // 15-bit window, gzip wrapper
+        initialized = rc == Z_OK;
+        return rc;
+    }
+    ~GzipState() {
+        if (initialized)
+            inflateEnd(&stream);
+    }
+};
+#else
+struct BlockReader::GzipState {};
+#endif
+
+// Constructor
+// pre: blockSize > 0
+// post: reader holds two empty buffers of 'blockSize' bytes; no file is open
+BlockReader::BlockReader(std::size_t blockSize) : blockSize_(blockSize == 0 ? kDefaultBlockSize : blockSize) {}
+
+// Destructor
+// pre: none
+// post: the reader thread has been stopped and joined, the file is closed
+BlockReader::~BlockReader() { close(); }
+
+// Opens the input and starts reading ahead
+// pre: no file is open yet
+// post: on NO_ERROR the first block is being (or has been) read;
+//       FILE_NOT_FOUND if 'path' is missing or not a regular file,
+//       UNABLE_TO_OPEN_FILE if it cannot be opened for reading,
+//       INSUFFICIENT_MEMORY if zlib cannot allocate its inflate state
+error_type BlockReader::open(const std::filesystem::path &path) {
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0)
+        return errno == ENOENT || errno == ENOTDIR ? FILE_NOT_FOUND : UNABLE_TO_OPEN_FILE;
+
+    struct stat st{};
+    if (::fstat(fd_, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close();
+        return FILE_NOT_FOUND;
+    }
+
+    unsigned char magic[4] = {};
+    const ssize_t magicLength = ::pread(fd_, magic, sizeof magic, 0);
+    if (magicLength == 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) {
+        close();
+        return UNSUPPORTED_FILE_FORMAT;   // zstd
+    }
+    if (magicLength >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) {
+#ifdef P3_HAVE_ZLIB
+        // Compressed size says nothing about the text size: always read ahead.
+        gzip_ = std::make_unique<GzipState>();
+        if (const int rc = gzip_->init(); rc != Z_OK) {
+            gzip_.reset();
+            close();
+            return rc == Z_MEM_ERROR ? INSUFFICIENT_MEMORY : UNABLE_TO_OPEN_FILE;
+        }
+        buffers_[0].data.resize(blockSize_);
+        buffers_[1].data.resize(blockSize_);
+        worker_ = std::thread(&BlockReader::readAhead, this, 0);
+        return NO_ERROR;
+#else
+        close();
+        return UNSUPPORTED_FILE_FORMAT;
+#endif
+    }
+
+    const auto fileSize = static_cast<std::size_t>(st.st_size);
+    if (fileSize < blockSize_) {
+        // Fits in one block: read it inline, no thread and no handoff. The
+        // spare byte tells us if the file grew since fstat.
+        Buffer &only = buffers_[0];
+        only.data.resize(fileSize + 1);
+        const long got = readBlock(only.data.data(), only.data.size());
+        if (got < 0) {
+            status_ = FAILED_TO_READ_FILE;
+            eof_ = true;
+            return NO_ERROR;
+        }
+        only.size = static_cast<std::size_t>(got);
+        only.full = got > 0;
+        if (only.size < only.data.size()) {
+            eof_ = true;
+            return NO_ERROR;
+        }
+        buffers_[1].data.resize(blockSize_);
+        worker_ = std::thread(&BlockReader::readAhead, this, 1);
+        return NO_ERROR;
+    }
+
+    buffers_[0].data.resize(blockSize_);
+    buffers_[1].data.resize(blockSize_);
+    worker_ = std::thread(&BlockReader::readAhead, this, 0);
+    return NO_ERROR;
+}
+
+// Opens standard input and starts reading ahead
+// pre: no file is open yet
+// post: on NO_ERROR the reader thread is waiting for input on a duplicate of
+//       descriptor 0; UNABLE_TO_OPEN_FILE if it could not be duplicated
+error_type BlockReader::openStdin() {
+    fd_ = ::dup(STDIN_FILENO);
+    if (fd_ < 0)
+        return UNABLE_TO_OPEN_FILE;
+    streaming_ = true;
+    buffers_[0].data.resize(blockSize_);
+    buffers_[1].data.resize(blockSize_);
+    worker_ = std::thread(&BlockReader::readAhead, this, 0);
+    return NO_ERROR;
+}
+
+// Reads up to 'capacity' bytes, stopping early only at end of file
+// (or, for stdin, as soon as anything was read)
+// pre: fd_ is open
+// post: returns the number of bytes read, or -1 on a read error
+long BlockReader::readBlock(char *data, std::size_t capacity) {
+    std::size_t filled = 0;
+    while (filled < capacity) {
+        const ssize_t got = ::read(fd_, data + filled, capacity - filled);
+        if (got < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        if (got == 0)
+            break;
+        filled += static_cast<std::size_t>(got);
+        if (streaming_)
+            break;
+    }
+    return static_cast<long>(filled);
+}
+
+// Produces the next block of text, inflating it first if the input is gzip
+// pre: fd_ is open
+// post: returns the number of text bytes written to 'data' (0 at end of input),
+//       or -1 on a read error or corrupt/truncated compressed data. Zero bytes
+//       after a member are skipped; other trailing bytes must form another member
+long BlockReader::fillBlock(char *data, std::size_t capacity) {
+    if (!gzip_)
+        return readBlock(data, capacity);
+#ifdef P3_HAVE_ZLIB
+    z_stream &zs = gzip_->stream;
+    zs.next_out = reinterpret_cast<Bytef *>(data);
+    zs.avail_out = static_cast<uInt>(capacity);
+    while (zs.avail_out > 0) {
+        if (zs.avail_in == 0) {
+            const long got = readBlock(reinterpret_cast<char *>(gzip_->input.data()), gzip_->input.size());
+            if (got < 0)
+                return -1;
+            if (got == 0) {
+                if (!gzip_->memberEnded)
+                    return -1;   // truncated stream
+                break;
+            }
+            zs.next_in = gzip_->input.data();
+            zs.avail_in = static_cast<uInt>(got);
+        }
+        if (gzip_->memberEnded) {
+            // Zero bytes after a member are padding (tape blocks, dd), ignored like gzip(1) does.
+            while (zs.avail_in > 0 && *zs.next_in == 0) {
+                ++zs.next_in;
+                --zs.avail_in;
+            }
+            if (zs.avail_in == 0)
+                continue;
+            // Anything else is the next member of a concatenated gzip file.
+            inflateReset(&zs);
+            gzip_->memberEnded = false;
+        }
+        const int rc = inflate(&zs, Z_NO_FLUSH);
+        if (rc == Z_STREAM_END)
+            gzip_->memberEnded = true;
+        else if (rc != Z_OK && !(rc == Z_BUF_ERROR && zs.avail_in == 0))
+            return -1;
+    }
+    return static_cast<long>(capacity - zs.avail_out);
+#else
+    return -1;
+#endif
+}
+
+// Worker thread: fills the buffers alternately, waiting while the next one is still in use
+// pre: fd_ is open, both buffers are allocated, 'index' is the buffer to fill first
+// post: every remaining block of the file was published in order, then eof_ was set
+void BlockReader::readAhead(std::size_t index) {
+    for (;; index ^= 1) {
+        Buffer &buffer = buffers_[index];
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [&] { return !buffer.full || stop_; });
+            if (stop_)
+                return;
+        }
+
+        // The consumer never touches a buffer that is not full, so this read needs no lock.
+        const long got = fillBlock(buffer.data.data(), buffer.data.size());
+
+        std::lock_guard lock(mutex_);
+        if (got < 0)
+            status_ = FAILED_TO_READ_FILE;
+        if (got <= 0) {
+            eof_ = true;
+            cv_.notify_all();
+            return;
+        }
+        buffer.size = static_cast<std::size_t>(got);
+        buffer.full = true;
+        cv_.notify_all();
+    }
+}
+
+// Hands the next filled block to the caller
+// pre: open() returned NO_ERROR
+// post: the previously returned block is released to the reader thread;
+//       returns true with 'block' set, or false when input is exhausted
+bool BlockReader::next(std::string_view &block) {
+    std::unique_lock lock(mutex_);
+    if (handedOut_ >= 0) {
+        buffers_[handedOut_].full = false;
+        handedOut_ = -1;
+        cv_.notify_all();
+    }
+
+    Buffer &buffer = buffers_[nextIndex_];
+    cv_.wait(lock, [&] { return buffer.full || eof_; });
+    if (!buffer.full)
+        return false;
+
+    block = std::string_view(buffer.data.data(), buffer.size);
+    handedOut_ = static_cast<int>(nextIndex_);
+    nextIndex_ ^= 1;
+    return true;
+}
+
+// pre: none
+// post: returns the read status
+error_type BlockReader::status() const {
+    std::lock_guard lock(mutex_);
+    return status_;
+}
+
+// Stops the reader thread and closes the file
+// pre: none
+// post: worker_ is joined, fd_ is closed
+void BlockReader::close() noexcept {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable())
+        worker_.join();
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef P3_PART1_BLOCKREADER_H
+#define P3_PART1_BLOCKREADER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "utils.hpp"
+
+// Read-ahead file input with double buffering. A background thread fills one
+// fixed-size block while the caller tokenizes the other, so disk reads and
+// scanning overlap instead of alternating. Files that fit in a single block
+// are read inline without starting a thread.
+//
+// Blocks are handed out in file order; a word may straddle two blocks, which
+// Tokenizer handles by carrying its state across feed() calls.
+//
+// gzip input (detected by its magic bytes, not the file name) is inflated on
+// the reader thread, so decompression and scanning run side by side and the
+// caller sees plain text. zstd input is recognised but not decoded.
+class BlockReader {
+public:
+    static constexpr std::size_t kDefaultBlockSize = 256 * 1024;
+
+    explicit BlockReader(std::size_t blockSize = kDefaultBlockSize);
+    ~BlockReader();   // stops and joins the reader thread, closes the file
+
+    BlockReader(const BlockReader &) = delete;
+    BlockReader &operator=(const BlockReader &) = delete;
+
+    // Open 'path' and start reading ahead. Returns FILE_NOT_FOUND,
+    // UNABLE_TO_OPEN_FILE, UNSUPPORTED_FILE_FORMAT, INSUFFICIENT_MEMORY (gzip
+    // input, zlib could not allocate) or NO_ERROR.
+    error_type open(const std::filesystem::path &path);
+
+    // Read standard input instead of a file. Each block is handed out as soon
+    // as some input arrives, so a pipe from a live log is tokenized as it grows.
+    // Returns UNABLE_TO_OPEN_FILE or NO_ERROR.
+    error_type openStdin();
+
+    // Next block of input. The view stays valid until the following call.
+    // Returns false at end of input or after a read error (see status()).
+    bool next(std::string_view &block);
+
+    // NO_ERROR, or FAILED_TO_READ_FILE if a read failed or compressed
+    // input was corrupt or truncated. Zero padding after the last gzip member
+    // is ignored, as gzip(1) does; any other trailing bytes count as corrupt.
+    [[nodiscard]] error_type status() const;
+
+private:
+    struct GzipState;   // zlib stream, defined in BlockReader.cpp
+
+    struct Buffer {
+        std::vector<char> data;
+        std::size_t size = 0;
+        bool full = false;
+    };
+
+    std::size_t blockSize_;
+    int fd_ = -1;
+    bool streaming_ = false;        // stdin: return partial blocks instead of waiting to fill them
+    Buffer buffers_[2];
+    std::size_t nextIndex_ = 0;     // buffer the consumer takes next
+    int handedOut_ = -1;            // buffer the consumer is holding, or -1
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool eof_ = false;
+    bool stop_ = false;
+    error_type status_ = NO_ERROR;
+    std::thread worker_;
+    std::unique_ptr<GzipState> gzip_;   // set when the input is gzip-compressed
+
+    void readAhead(std::size_t index);                // worker thread body
+    long readBlock(char *data, std::size_t capacity); // read(2) retrying on EINTR
+    long fillBlock(char *data, std::size_t capacity); // readBlock, or inflate for gzip
+    void close() noexcept;
+};
+
+#endif //P3_PART1_BLOCKREADER_H
@@ -0,0 +1,418 @@
+#include "CodecServer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <exception>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Tokenizer.hpp"
+
+namespace {
+
+constexpr std::size_t kWrapColumns = 80;
+constexpr std::size_t kMaxInFlight = 64;    // pipelined requests per connection
+constexpr std::size_t kMaxLine = 64;        // longest request line accepted
+constexpr std::chrono::milliseconds kAcceptBackoff{100};   // pause after EMFILE and friends
+constexpr std::size_t kMaxPayload = std::size_t{256} << 20;   // largest ENCODE/DECODE payload, in bytes
+
+template <typename Rules>
+void tokenizeText(std::string_view text, std::vector<std::string> &tokens) {
+    Tokenizer<Rules> tokenizer;
+    auto sink = [&tokens](std::string &w) { tokens.push_back(std::move(w)); };
+    tokenizer.feed(text.data(), text.data() + text.size(), sink);
+    tokenizer.finish(sink);
+}
+
+std::string okResponse(std::string_view body) {
+    std::string out = "OK " + std::to_string(body.size()) + "\n";
+    out.append(body);
+    return out;
+}
+
+std::string errorResponse(std::string_view reason) {
+    std::string out = "ERR ";
+    out.append(reason);
+    out.push_back('\n');
+    return out;
+}
+
+// Buffered reads from a descriptor, for the request framing.
+class FdReader {
+public:
+    explicit FdReader(int fd) : fd_(fd) {}
+
+    // pre: none
+    // post: true with 'line' set (newline removed); false at end of input,
+    //       on a read error or if the line is longer than kMaxLine
+    bool readLine(std::string &line) {
+        line.clear();
+        for (;;) {
+            if (pos_ == end_ && !refill())
+                return false;
+            const char c = buffer_[pos_++];
+            if (c == '\n')
+                return true;
+            if (line.size() == kMaxLine)
+                return false;
+            line.push_back(c);
+        }
+    }
+
+    // pre: none
+    // post: true with exactly 'n' bytes in 'out'; false if input ended first.
+    //       'out' grows with the bytes that actually arrive, never ahead of them
+    bool readExact(std::size_t n, std::string &out) {
+        out.clear();
+        while (out.size() < n) {
+            if (pos_ == end_ && !refill())
+                return false;
+            const std::size_t take = std::min(n - out.size(), end_ - pos_);
+            out.append(buffer_ + pos_, take);
+            pos_ += take;
+        }
+        return true;
+    }
+
+private:
+    int fd_;
+    char buffer_[64 * 1024];
+    std::size_t pos_ = 0;
+    std::size_t end_ = 0;
+
+    bool refill() {
+        for (;;) {
+            const ssize_t got = ::read(fd_, buffer_, sizeof buffer_);
+            if (got < 0 && errno == EINTR)
+                continue;
+            if (got <= 0)
+                return false;
+            pos_ = 0;
+            end_ = static_cast<std::size_t>(got);
+            return true;
+        }
+    }
+};
+
+// pre: none
+// post: returns true if all of 'data' was written to 'fd'
+bool writeAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        const ssize_t put = ::write(fd, data.data(), data.size());
+        if (put < 0 && errno == EINTR)
+            continue;
+        if (put <= 0)
+            return false;
+        data.remove_prefix(static_cast<std::size_t>(put));
+    }
+    return true;
+}
+
+// pre: none
+// post: returns the length in "ENCODE <n>"-style 'digits', or kMaxPayload + 1
+//       if it is larger than kMaxPayload; false if 'digits' is not a decimal number
+bool parseLength(const char *digits, std::size_t &length) {
+    if (*digits < '0' || *digits > '9')
+        return false;
+    length = 0;
+    for (; *digits >= '0' && *digits <= '9'; digits++)
+        length = std::min(length * 10 + static_cast<std::size_t>(*digits - '0'), kMaxPayload + 1);
+    return *digits == '\0';
+}
+
+std::future<std::string> readyResponse(std::string response) {
+    std::promise<std::string> promise;
+    promise.set_value(std::move(response));
+    return promise.get_future();
+}
+
+} // namespace
+
+// Constructor
+// pre: 'rules' is one of ascii, alnum, hyphen, utf8 (anything else means ascii)
+// post: the pool is running; no codebook is loaded yet
+CodecServer::CodecServer(const std::string &rules, std::size_t threads)
+    : tokenize_(rules == "alnum"  ? &tokenizeText<AlnumWordRules>
+              : rules == "hyphen" ? &tokenizeText<HyphenWordRules>
+              : rules == "utf8"   ? &tokenizeText<Utf8WordRules>
+              : &tokenizeText<AsciiWordRules>),
+      pool_(threads) {}
+
+// Reads the codebook
+// pre: no requests are being served
+// post: on NO_ERROR the tree and the symbol index describe 'headerFile'
+error_type CodecServer::load(const std::filesystem::path &headerFile) {
+    std::ifstream in(headerFile);
+    if (!in.is_open())
+        return regularFileExists(headerFile.string()) != NO_ERROR ? FILE_NOT_FOUND : UNABLE_TO_OPEN_FILE;
+
+    codes_.clear();
+    if (auto status = tree_.readHeader(in); status != NO_ERROR)
+        return status;
+
+    const std::vector<HuffmanTree::Code> &codebook = tree_.codebook();
+    codes_.reserve(codebook.size());
+    hasPhrases_ = false;
+    for (std::size_t i = 0; i < codebook.size(); i++) {
+        const std::string_view symbol = tree_.symbol(i);
+        codes_.emplace(symbol, codebook[i]);
+        hasPhrases_ = hasPhrases_ || symbol.find(' ') != std::string_view::npos;
+    }
+    return NO_ERROR;
+}
+
+// pre: load() succeeded
+// post: returns the framed response for one request
+std::string CodecServer::handle(std::string_view command, std::string_view payload) const {
+    if (command == "ENCODE")
+        return encode(payload);
+    if (command == "DECODE")
+        return decode(payload);
+    if (command == "PING")
+        return okResponse({});
+    return errorResponse("unknown command");
+}
+
+// Encodes text with the resident codebook
+// pre: load() succeeded
+// post: returns the code in .code layout, or ERR naming the first word missing
+//       from the codebook. With phrases, pairs are matched greedily left to
+//       right like PhraseModel::segment
+std::string CodecServer::encode(std::string_view text) const {
+    std::vector<std::string> tokens;
+    tokenize_(text, tokens);
+
+    std::string bits;
+    std::size_t col = 0;
+    std::string pair;
+    for (std::size_t i = 0; i < tokens.size(); i++) {
+        auto it = codes_.end();
+        if (hasPhrases_ && i + 1 < tokens.size()) {
+            pair.assign(tokens[i]).append(1, ' ').append(tokens[i + 1]);
+            it = codes_.find(pair);
+            if (it != codes_.end())
+                i++;
+        }
+        if (it == codes_.end())
+            it = codes_.find(tokens[i]);
+        if (it == codes_.end())
+            return errorResponse("unknown word " + tokens[i]);
+
+        const HuffmanTree::Code code = it->second;
+        for (std::uint32_t b = code.length; b-- > 0;) {
+            bits.push_back(((code.bits >> b) & 1u) ? '1' : '0');
+            if (++col == kWrapColumns) {
+                bits.push_back('\n');
+                col = 0;
+            }
+        }
+    }
+    if (col != 0)
+        bits.push_back('\n');
+    return okResponse(bits);
+}
+
+// Decodes bits with the resident tree
+// pre: load() succeeded
+// post: returns the tokens one per line, or ERR if the bits are not a valid code
+std::string CodecServer::decode(std::string_view bits) const {
+    std::ostringstream tokens;
+    if (tree_.decode(bits, tokens) != NO_ERROR)
+        return errorResponse("invalid code");
+    return okResponse(tokens.view());
+}
+
+// Request loop for one connection
+// pre: load() succeeded; 'inFd' and 'outFd' stay open until this returns
+// post: every request read before end of input (or QUIT) has been answered in
+//       order; if no writer thread can be started, nothing is read or answered
+void CodecServer::serveStream(int inFd, int outFd) {
+    std::signal(SIGPIPE, SIG_IGN);   // a client that hangs up must not kill the server
+
+    std::deque<std::future<std::string>> inFlight;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool readerDone = false;
+
+    // Responses are written in request order while later requests are still being computed.
+    // Without a writer thread there is no way to answer, so the connection is dropped.
+    std::thread writer;
+    try {
+        writer = std::thread([&] {
+            bool connected = true;
+            for (;;) {
+                std::future<std::string> next;
+                {
+                    std::unique_lock lock(mutex);
+                    cv.wait(lock, [&] { return readerDone || !inFlight.empty(); });
+                    if (inFlight.empty())
+                        return;
+                    next = std::move(inFlight.front());
+                }
+                std::string response;
+                try {
+                    response = next.get();
+                } catch (const std::exception &) {
+                    response = errorResponse("internal error");
+                }
+                connected = connected && writeAll(outFd, response);
+                {
+                    std::lock_guard lock(mutex);
+                    inFlight.pop_front();
+                }
+                cv.notify_all();
+            }
+        });
+    } catch (const std::system_error &) {
+        return;
+    }
+
+    const auto enqueue = [&](std::future<std::string> response) {
+        std::unique_lock lock(mutex);
+        cv.wait(lock, [&] { return inFlight.size() < kMaxInFlight; });
+        inFlight.push_back(std::move(response));
+        cv.notify_all();
+    };
+
+    // Out of memory while framing a request ends this connection only.
+    try {
+        FdReader reader(inFd);
+        std::string line;
+        while (reader.readLine(line)) {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty())
+                continue;   // the newline many clients write after a payload
+            if (line == "QUIT")
+                break;
+            if (line == "PING") {
+                enqueue(readyResponse(handle(line, {})));
+                continue;
+            }
+
+            const std::size_t space = line.find(' ');
+            const std::string command = line.substr(0, space);
+            std::size_t size = 0;
+            if ((command != "ENCODE" && command != "DECODE") || space == std::string::npos || !parseLength(line.c_str() + space + 1, size)) {
+                enqueue(readyResponse(errorResponse("bad request")));
+                break;   // the payload length is unknown, so the stream cannot be resynchronised
+            }
+            if (size > kMaxPayload) {
+                enqueue(readyResponse(errorResponse("request too large")));
+                break;   // skipping the payload would mean reading it
+            }
+
+            std::string payload;
+            if (!reader.readExact(size, payload)) {
+                enqueue(readyResponse(errorResponse("truncated request")));
+                break;
+            }
+            // Whatever one request throws (bad_alloc on a huge text, say) is its own ERR, not the server's end.
+            enqueue(pool_.submit([this, command, payload = std::move(payload)] {
+                try {
+                    return handle(command, payload);
+                } catch (const std::exception &) {
+                    return errorResponse("internal error");
+                }
+            }));
+        }
+    } catch (const std::exception &) {
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        readerDone = true;
+    }
+    cv.notify_all();
+    writer.join();
+}
+
+// Accept loop on a Unix socket
+// pre: load() succeeded
+// post: serves connections until accept() fails for a reason other than an
+//       interrupted call or a shortage of descriptors or buffers (those are
+//       retried), then waits for open connections to finish and returns
+//       FAILED_TO_ACCEPT_CONNECTION. Returns UNABLE_TO_OPEN_FILE_FOR_WRITING if
+//       'path' exists and is not a socket, UNABLE_TO_OPEN_FILE if the socket
+//       could not be created, bound or listened on
+error_type CodecServer::serveSocket(const std::filesystem::path &path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    const std::string name = path.string();
+    if (name.empty() || name.size() >= sizeof addr.sun_path)
+        return UNABLE_TO_OPEN_FILE;
+    std::memcpy(addr.sun_path, name.c_str(), name.size() + 1);
+
+    // Only a stale socket is replaced; any other file at 'path' (a codebook, say) is left alone.
+    struct stat existing {};
+    if (::lstat(name.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode))
+            return UNABLE_TO_OPEN_FILE_FOR_WRITING;
+        ::unlink(name.c_str());
+    }
+
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+        return UNABLE_TO_OPEN_FILE;
+    if (::bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof addr) != 0 || ::listen(listener, 64) != 0) {
+        ::close(listener);
+        return UNABLE_TO_OPEN_FILE;
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // Open connections, so a failed accept loop can let them finish before returning.
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t connections = 0;
+
+    for (;;) {
+        const int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                // Out of descriptors or buffers: wait for connections to close, then try again.
+                std::this_thread::sleep_for(kAcceptBackoff);
+                continue;
+            }
+            break;
+        }
+        // The reader thread only parses frames; the pool does the coding.
+        {
+            std::lock_guard lock(mutex);
+            ++connections;
+        }
+        try {
+            std::thread([this, client, &mutex, &cv, &connections] {
+                serveStream(client, client);
+                ::close(client);
+                std::lock_guard lock(mutex);   // notify under the lock: serveSocket may return right after
+                --connections;
+                cv.notify_all();
+            }).detach();
+        } catch (const std::system_error &) {
+            ::close(client);   // no thread to spare: drop this client, keep the others
+            std::lock_guard lock(mutex);
+            --connections;
+        }
+    }
+    ::close(listener);
+
+    std::unique_lock lock(mutex);
+    cv.wait(lock, [&] { return connections == 0; });
+    return FAILED_TO_ACCEPT_CONNECTION;
+}
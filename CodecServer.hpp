@@ -0,0 +1,71 @@
+#ifndef P3_PART1_CODECSERVER_H
+#define P3_PART1_CODECSERVER_H
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "HuffmanTree.h"
+#include "ThreadPool.hpp"
+#include "utils.hpp"
+
+// Long-running encoder/decoder around one resident codebook. The header is
+// read once; every request after that is a hash lookup per token (encode) or
+// a tree walk (decode), run on a thread pool.
+//
+// Requests and responses are framed the same way on stdin/stdout and on a
+// Unix socket:
+//   ENCODE <n>\n<n bytes of text>   -> code in .code format (80 columns)
+//   DECODE <n>\n<n bytes of code>   -> tokens in .tokens format
+//   PING\n                          -> empty response
+//   QUIT\n                          -> closes the connection
+// The payload is exactly n bytes; a newline after it (or any blank line
+// between requests) is skipped, so "ENCODE 5\nhello\n" is one request.
+// A response is "OK <m>\n" followed by m bytes, or a single "ERR <reason>\n"
+// line. Requests on one connection may be pipelined; their responses come
+// back in request order. A payload over 256 MiB is answered with
+// "ERR request too large" and ends that connection, as does a malformed
+// request line; other connections are unaffected.
+class CodecServer {
+public:
+    // 'rules' names the tokenizer rule set for ENCODE text (ascii, alnum,
+    // hyphen or utf8); 'threads' == 0 uses one worker per hardware thread.
+    CodecServer(const std::string &rules, std::size_t threads);
+
+    // Load the codebook from a header written by HuffmanTree::writeHeader.
+    // Returns FILE_NOT_FOUND, UNABLE_TO_OPEN_FILE, FAILED_TO_READ_FILE or NO_ERROR.
+    error_type load(const std::filesystem::path &headerFile);
+
+    // Serve one connection until end of input or QUIT.
+    void serveStream(int inFd, int outFd);
+
+    // Listen on a Unix socket at 'path' (replacing a stale socket file) and
+    // serve each connection on its own reader thread. Only returns if 'path'
+    // is an existing file that is not a socket (UNABLE_TO_OPEN_FILE_FOR_WRITING),
+    // the socket cannot be set up (UNABLE_TO_OPEN_FILE), or accept() fails
+    // with an error that retrying will not fix (FAILED_TO_ACCEPT_CONNECTION,
+    // after the open connections have been answered). Running out of file
+    // descriptors is waited out, not treated as failure.
+    error_type serveSocket(const std::filesystem::path &path);
+
+    // Answer a single request in-process; 'command' is "ENCODE", "DECODE" or "PING".
+    // Safe to call from several threads at once.
+    [[nodiscard]] std::string handle(std::string_view command, std::string_view payload) const;
+
+private:
+    using TokenizeFn = void (*)(std::string_view text, std::vector<std::string> &tokens);
+
+    HuffmanTree tree_;
+    std::unordered_map<std::string_view, HuffmanTree::Code> codes_;   // symbol -> code, views into tree_
+    bool hasPhrases_ = false;
+    TokenizeFn tokenize_;
+    ThreadPool pool_;
+
+    [[nodiscard]] std::string encode(std::string_view text) const;
+    [[nodiscard]] std::string decode(std::string_view bits) const;
+};
+
+#endif //P3_PART1_CODECSERVER_H
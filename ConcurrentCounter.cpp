@@ -0,0 +1,115 @@
+#include "ConcurrentCounter.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// Constructor
+// pre: none
+// post: an empty counter with a power-of-two number of shards
+ConcurrentCounter::ConcurrentCounter(std::size_t shards) {
+    if (shards == 0)
+        shards = 8 * std::max(1u, std::thread::hardware_concurrency());
+    shardCount_ = std::bit_ceil(std::max<std::size_t>(shards, 2));
+    shards_ = std::make_unique<Shard[]>(shardCount_);
+    shift_ = 64 - static_cast<unsigned>(std::countr_zero(shardCount_));
+}
+
+// pre: none
+// post: returns the shard that owns 'word'. The hash is remixed so the shard
+//       index and the bucket index inside the shard use different bits
+ConcurrentCounter::Shard &ConcurrentCounter::shardOf(std::string_view word) const noexcept {
+    const std::uint64_t mixed = static_cast<std::uint64_t>(Hash{}(word)) * 0x9E3779B97F4A7C15ull;
+    return shards_[mixed >> shift_];
+}
+
+// Adds 'count' occurrences of 'word'
+// pre: none
+// post: countOf(word) has grown by 'count'
+void ConcurrentCounter::insert(std::string_view word, std::uint64_t count) {
+    Shard &shard = shardOf(word);
+    {
+        std::shared_lock lock(shard.mutex);
+        if (auto it = shard.counts.find(word); it != shard.counts.end()) {
+            it->second.fetch_add(count, std::memory_order_relaxed);
+            return;
+        }
+    }
+    // First sighting in this shard; another thread may have added it since the shared lock was dropped.
+    std::unique_lock lock(shard.mutex);
+    auto [it, added] = shard.counts.try_emplace(std::string(word), 0);
+    it->second.fetch_add(count, std::memory_order_relaxed);
+}
+
+// pre: none
+// post: returns the count of 'word', 0 if it has not been inserted
+std::uint64_t ConcurrentCounter::countOf(std::string_view word) const {
+    const Shard &shard = shardOf(word);
+    std::shared_lock lock(shard.mutex);
+    auto it = shard.counts.find(word);
+    return it == shard.counts.end() ? 0 : it->second.load(std::memory_order_relaxed);
+}
+
+// pre: none
+// post: returns the number of distinct words inserted
+std::size_t ConcurrentCounter::size() const {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < shardCount_; i++) {
+        std::shared_lock lock(shards_[i].mutex);
+        total += shards_[i].counts.size();
+    }
+    return total;
+}
+
+// Exports all counts
+// pre: none
+// post: 'out' holds every (word, count) pair sorted by word, like
+//       BinSearchTree::inorderCollect
+void ConcurrentCounter::snapshot(std::vector<std::pair<std::string, std::uint64_t>> &out) const {
+    out.clear();
+    for (std::size_t i = 0; i < shardCount_; i++) {
+        std::shared_lock lock(shards_[i].mutex);
+        for (const auto &[word, count] : shards_[i].counts)
+            out.emplace_back(word, count.load(std::memory_order_relaxed));
+    }
+    std::sort(out.begin(), out.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+}
+
+// Constructor
+// pre: 'counter' outlives the batch; flushEvery > 0
+// post: an empty local table in front of 'counter'
+ConcurrentCounter::Batch::Batch(ConcurrentCounter &counter, std::size_t flushEvery)
+    : counter_(counter), flushEvery_(flushEvery == 0 ? 1 : flushEvery) {
+    local_.reserve(flushEvery_);
+}
+
+// Destructor
+// pre: none
+// post: pending counts have been merged into the shared counter
+ConcurrentCounter::Batch::~Batch() {
+    flush();
+}
+
+// Counts one occurrence of 'word' locally
+// pre: none
+// post: the local table is merged once it holds 'flushEvery' distinct words
+void ConcurrentCounter::Batch::insert(std::string_view word) {
+    if (auto it = local_.find(word); it != local_.end()) {
+        ++it->second;
+        return;
+    }
+    local_.emplace(std::string(word), 1);
+    if (local_.size() >= flushEvery_)
+        flush();
+}
+
+// Merges the local counts
+// pre: none
+// post: the shared counter includes every word counted by this batch; the local table is empty
+void ConcurrentCounter::Batch::flush() {
+    for (const auto &[word, count] : local_)
+        counter_.insert(word, count);
+    local_.clear();
+}
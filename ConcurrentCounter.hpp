@@ -0,0 +1,89 @@
+#ifndef P3_PART1_CONCURRENTCOUNTER_H
+#define P3_PART1_CONCURRENTCOUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Word counter that many producer threads can update at once.
+// Words are spread over independent shards by hash; each shard has its own
+// reader/writer lock and its counts are atomics. Counting a word already in
+// the table takes the shard's shared lock and one atomic add, so threads
+// counting known words never wait for each other's exclusive lock, which is
+// held only to insert a word the first time it is seen in that shard.
+//
+// That is not contention-free. Taking the shared lock is itself a write to
+// the shard's lock word, so every insert() of a hot word makes all threads
+// write the same two cache lines, the lock and the count. On skewed (Zipf)
+// text per-token insert() therefore stops scaling with threads; Batch, which
+// adds up tokens locally and merges each distinct word once per flush, is the
+// path meant to scale.
+class ConcurrentCounter {
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+
+public:
+    // 'shards' is rounded up to a power of two; 0 picks a few per hardware thread.
+    explicit ConcurrentCounter(std::size_t shards = 0);
+
+    ConcurrentCounter(const ConcurrentCounter &) = delete;
+    ConcurrentCounter &operator=(const ConcurrentCounter &) = delete;
+
+    // Thread-safe.
+    void insert(std::string_view word, std::uint64_t count = 1);
+
+    // Thread-safe; 0 if the word has not been inserted. Concurrent inserts of
+    // 'word' may or may not be included.
+    [[nodiscard]] std::uint64_t countOf(std::string_view word) const;
+
+    // Distinct words so far (thread-safe; approximate while inserts run).
+    [[nodiscard]] std::size_t size() const;
+
+    // (word, count) pairs sorted by word, the order of BinSearchTree::inorderCollect.
+    // Taken shard by shard: exact once all producers have finished.
+    void snapshot(std::vector<std::pair<std::string, std::uint64_t>> &out) const;
+
+    // Per-thread front end: counts into a private table and merges it into the
+    // shared counter every 'flushEvery' distinct words, on flush(), and on destruction.
+    class Batch {
+    public:
+        explicit Batch(ConcurrentCounter &counter, std::size_t flushEvery = 4096);
+        ~Batch();
+
+        Batch(const Batch &) = delete;
+        Batch &operator=(const Batch &) = delete;
+
+        void insert(std::string_view word);
+        void flush();
+
+    private:
+        ConcurrentCounter &counter_;
+        std::size_t flushEvery_;
+        std::unordered_map<std::string, std::uint64_t, Hash, std::equal_to<>> local_;
+    };
+
+private:
+    // One cache line apart so two shards' locks never share a line.
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, std::atomic<std::uint64_t>, Hash, std::equal_to<>> counts;
+    };
+
+    std::unique_ptr<Shard[]> shards_;
+    std::size_t shardCount_;
+    unsigned shift_;   // shard index = top bits of the mixed hash
+
+    [[nodiscard]] Shard &shardOf(std::string_view word) const noexcept;
+};
+
+#endif //P3_PART1_CONCURRENTCOUNTER_H
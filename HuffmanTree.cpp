@@ -4,56 +4,126 @@
 
 #include "HuffmanTree.h"
 #include "PriorityQueue.hpp"
-#include <cassert>
-
-// Destructor
-// Pre: none
-// Post: all nodes in the tree are deleted
-HuffmanTree::~HuffmanTree () { destroy(root_); }
-
-// Recursively deletes a subtree
-// Pre: 'n' is a nullptr or the root of a valid tree
-// Post: all nodes branched from n are delted
-void HuffmanTree::destroy (TreeNode* n) noexcept {
-    if (!n) return;
-    destroy (n->left);
-    destroy (n->right);
-    delete n;
-}
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 // Builds a Huffman Tree from word-frequency counts
 // Pre: 'counts' may be empty; each frequency is >= 0
 // Post: returns a HuffmanTree representing all words with count > 0;
 //       if none exist, tree is empty
-HuffmanTree HuffmanTree::buildFromCounts(const std::vector<std::pair<std::string, int> > &counts) {
-    std::vector<TreeNode*> nodes;
-    nodes.reserve(counts.size());
+HuffmanTree HuffmanTree::buildFromCounts(const std::vector<std::pair<std::string, std::uint64_t>> &counts) {
+    HuffmanTree ht;
+    std::size_t chars = 0;
+    for (const auto& [w,c] : counts) chars += w.size();
+    ht.nodes_.reserve(2 * counts.size(), chars);   // n leaves and at most n - 1 parents
+
+    std::vector<Index> leaves;
+    leaves.reserve(counts.size());
     for (const auto& [w,c] : counts) {
-        if (c > 0) nodes.push_back(new TreeNode(w, c));
+        if (c > 0) leaves.push_back(ht.nodes_.add(w, c));
     }
+    ht.buildFromLeaves(std::move(leaves));
+    ht.buildCodebook();
+    return ht;
+}
+
+// Builds a Huffman Tree from interned token counts
+// Pre: 'ranked' holds ids of 'dict' with counts[id] > 0, ideally from rankIds
+// Post: returns a HuffmanTree with an id-indexed codebook (codeOfId_);
+//       if 'ranked' is empty, tree is empty
+HuffmanTree HuffmanTree::buildFromIds(const std::vector<TokenDictionary::Id>& ranked,
+                                      const std::vector<std::uint64_t>& counts,
+                                      const TokenDictionary& dict) {
     HuffmanTree ht;
+    std::size_t chars = 0;
+    for (TokenDictionary::Id id : ranked) chars += dict.word(id).size();
+    ht.nodes_.reserve(2 * ranked.size(), chars);
+
+    std::vector<Index> leaves;
+    leaves.reserve(ranked.size());
+    for (TokenDictionary::Id id : ranked) {
+        leaves.push_back(ht.nodes_.add(dict.word(id), counts[id]));
+    }
+    ht.buildFromLeaves(std::move(leaves));
+    ht.buildCodebook();
 
-    if (nodes.empty()) {
-        ht.root_ = nullptr;
-        return ht;
+    // Leaves were added first, so leaf node k holds ranked[k].
+    if (!ht.leaves_.empty()) {
+        ht.codeOfId_.assign(dict.size(), TreeNode::kNull);
+        for (std::size_t i = 0; i < ht.leaves_.size(); i++) {
+            ht.codeOfId_[ranked[ht.leaves_[i]]] = static_cast<std::uint32_t>(i);
+        }
     }
-    if (nodes.size() == 1) {
-        ht.root_ = nodes.front();
-        return ht;
+    return ht;
+}
+
+// Merges leaves into a single Huffman tree
+// Pre: 'leaves' holds leaves of nodes_ with freq > 0
+// Post: root_ is the root (kNull if 'leaves' is empty); the two lowest-priority
+//       nodes are merged first and the first extracted becomes the left child.
+//       Parent frequencies are 64-bit sums, so they cannot overflow
+void HuffmanTree::buildFromLeaves(std::vector<Index> leaves) {
+    root_ = TreeNode::kNull;
+    if (leaves.empty())
+        return;
+    if (leaves.size() == 1) {
+        root_ = leaves.front();
+        return;
     }
 
-    PriorityQueue pq(std::move(nodes));
+    PriorityQueue pq(nodes_, std::move(leaves));
     while (pq.size() > 1) {
-        TreeNode* a = pq.extractMin();
-        TreeNode* b = pq.extractMin();
-        TreeNode* parent = new TreeNode(std::string{}, a->freq + b->freq);
+        const Index a = pq.extractMin();
+        const Index b = pq.extractMin();
+        pq.insert(nodes_.addParent(a, b));
+    }
+    root_ = pq.extractMin();
+}
 
-        parent->left = a;
-        parent->right = b;
-        pq.insert(parent);
+// Packs the code of every leaf in one pre-order traversal
+// Pre: root_ is set (or kNull)
+// Post: leaves_ and codes_ hold every leaf and its code in header order;
+//       codeOfId_ is cleared (buildFromIds fills it)
+void HuffmanTree::buildCodebook() {
+    leaves_.clear();
+    codes_.clear();
+    codeOfId_.clear();
+    if (root_ == TreeNode::kNull) return;
+    buildCodebookDFS(root_, Code{});
+    if (nodes_[root_].isLeaf())
+        codes_.front().length = 1;   // lone leaf: "0"
+}
+
+// DFS helper for buildCodebook
+// Pre: 'n' is kNull or a valid node whose path from the root is 'code'
+// Post: appends every leaf of this subtree and its code, left before right;
+//       throws std::length_error if a code would need more than 64 bits
+void HuffmanTree::buildCodebookDFS(Index n, Code code) {
+    if (n == TreeNode::kNull) return;
+    if (nodes_[n].isLeaf()) {
+        leaves_.push_back(n);
+        codes_.push_back(code);
+        return;
     }
-    ht.root_ = pq.extractMin();
-    return ht;
+    if (code.length == 64)
+        throw std::length_error("HuffmanTree: a code is longer than 64 bits");
+    buildCodebookDFS(nodes_[n].left, Code{code.bits << 1, code.length + 1});
+    buildCodebookDFS(nodes_[n].right, Code{(code.bits << 1) | 1u, code.length + 1});
+}
+
+// Unpacks a code
+// Pre: length <= 64
+// Post: returns 'length' characters '0'/'1', most significant bit first
+std::string HuffmanTree::Code::toString() const {
+    std::string out(length, '0');
+    for (std::uint32_t i = 0; i < length; i++) {
+        if ((bits >> (length - 1 - i)) & 1u) out[i] = '1';
+    }
+    return out;
 }
 
 // Assigns binary codes to all leaves
@@ -61,28 +131,50 @@ HuffmanTree HuffmanTree::buildFromCounts(const std::vector<std::pair<std::string
 // Post: 'out' is cleared and filled with word,code pairs for all leaves
 void HuffmanTree::assignCodes(std::vector<std::pair<std::string, std::string>>& out) const {
     out.clear();
-    if (!root_) return;
-    std::string prefix;
-    assignCodesDFS(root_, prefix, out);
+    out.reserve(codes_.size());
+    for (std::size_t i = 0; i < codes_.size(); i++) {
+        out.emplace_back(std::string(nodes_.word(leaves_[i])), codes_[i].toString());
+    }
 }
 
-// DFS helper for assignCodes
-// Pre: 'n' is nullptr or a valid node in the tree
-// Post: appends pairs for all leaves in this subtree to 'out'
-void HuffmanTree::assignCodesDFS(const TreeNode* n, std::string& prefix, std::vector<std::pair<std::string, std::string>>& out)  {
-    if (!n) return;
-    const bool isALeaf = (n->left == nullptr && n->right == nullptr);
-    if (isALeaf) {
-        out.emplace_back(n->word, prefix.empty() ? std::string("0") : prefix);
-        return;
+// Computes the size of the encoded stream
+// Pre: none
+// Post: returns sum of freq x code length over all leaves, 0 for an empty tree.
+//       codes_ already holds every length (a lone leaf's is 1), so no tree walk
+std::uint64_t HuffmanTree::encodedBits() const noexcept {
+    std::uint64_t bits = 0;
+    for (std::size_t i = 0; i < codes_.size(); i++) {
+        bits += leafBits(i);
     }
-    prefix.push_back('0');
-    assignCodesDFS(n->left, prefix, out);
-    prefix.pop_back();
+    return bits;
+}
 
-    prefix.push_back('1');
-    assignCodesDFS(n->right, prefix, out);
-    prefix.pop_back();
+// Computes length and entropy figures for the code
+// Pre: none
+// Post: returns the stats of every leaf from one pass over the codebook; all
+//       zero for an empty tree. totalBits sums leafBits() like encodedBits().
+//       Entropy is log2(T) - sum(f log2 f) / T over leaf frequencies f with total T
+CodeStats HuffmanTree::codeStats() const {
+    CodeStats stats;
+    double freqLogSum = 0.0;
+    for (std::size_t i = 0; i < codes_.size(); i++) {
+        const unsigned length = codes_[i].length;
+        const std::uint64_t freq = nodes_[leaves_[i]].freq;
+        if (stats.symbols == 0 || length < stats.minLength) stats.minLength = length;
+        if (length > stats.maxLength) stats.maxLength = length;
+        if (stats.lengthHistogram.size() <= length) stats.lengthHistogram.resize(length + 1, 0);
+        ++stats.lengthHistogram[length];
+        ++stats.symbols;
+        stats.tokens += freq;
+        stats.totalBits += leafBits(i);
+        if (freq > 0) freqLogSum += static_cast<double>(freq) * std::log2(static_cast<double>(freq));
+    }
+    if (stats.tokens > 0) {
+        const auto total = static_cast<double>(stats.tokens);
+        stats.averageLength = static_cast<double>(stats.totalBits) / total;
+        stats.entropy = std::max(0.0, std::log2(total) - freqLogSum / total);
+    }
+    return stats;
 }
 
 // Writes Huffman header to an output stream
@@ -90,38 +182,121 @@ void HuffmanTree::assignCodesDFS(const TreeNode* n, std::string& prefix, std::ve
 // Post: writes one line per leaf to 'os';
 //       returns NO_ERROR on success or FAILED_TO_WRITE_FILE on failure
 error_type HuffmanTree::writeHeader(std::ostream &os) const {
-    if (!root_) {
+    if (root_ == TreeNode::kNull) {
         return NO_ERROR;
     }
     if (!os.good()) return FAILED_TO_WRITE_FILE;
 
-    std::string prefix;
-    writeHeaderPreorder(root_, os, prefix);
+    std::string line;
+    for (std::size_t i = 0; i < codes_.size(); i++) {
+        const Code code = codes_[i];
+        line.assign(nodes_.word(leaves_[i]));
+        line.push_back(' ');
+        for (std::uint32_t b = code.length; b-- > 0;) {
+            line.push_back(((code.bits >> b) & 1u) ? '1' : '0');
+        }
+        line.push_back('\n');
+        os.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
 
     if (os.fail()) return FAILED_TO_WRITE_FILE;
 
     return NO_ERROR;
 }
 
-// Helper: preorder write of word/code pairs
-// Pre: 'n' is nullptr or a valid node; 'os' is open and writable
-// Post: writes "<word><code>\n" for each leaf in subtree rooted at 'n'
-void HuffmanTree::writeHeaderPreorder(const TreeNode *n, std::ostream &os, std::string &prefix) {
-    if (!n) return;
+// Reads a header back into a tree
+// Pre: 'is' holds lines "<symbol> <code>" as written by writeHeader
+// Post: on NO_ERROR the tree has one leaf per line at the path its code spells
+//       (a single "0" line gives a lone-leaf tree) and the codebook is rebuilt;
+//       on FAILED_TO_READ_FILE the tree is empty
+error_type HuffmanTree::readHeader(std::istream& is) {
+    nodes_.clear();
+    root_ = TreeNode::kNull;
+    leaves_.clear();
+    codes_.clear();
+    codeOfId_.clear();
 
-    const bool isALeaf = (n->left == nullptr && n->right == nullptr);
-    if (isALeaf) {
-        const std::string& code = prefix.empty() ? std::string("0") : prefix;
-        os << n->word << ' ' << code << '\n';
-        return;
+    std::vector<std::pair<std::string, std::string>> lines;
+    std::string line;
+    while (std::getline(is, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        const std::size_t space = line.rfind(' ');
+        if (space == std::string::npos || space == 0 || space + 1 == line.size())
+            return FAILED_TO_READ_FILE;
+        std::string code = line.substr(space + 1);
+        if (code.size() > 64 || code.find_first_not_of("01") != std::string::npos)
+            return FAILED_TO_READ_FILE;
+        line.resize(space);
+        lines.emplace_back(std::move(line), std::move(code));
     }
-    prefix.push_back('0');
-    writeHeaderPreorder(n->left, os, prefix);
-    prefix.pop_back();
+    if (is.bad())
+        return FAILED_TO_READ_FILE;
 
-    prefix.push_back('1');
-    writeHeaderPreorder(n->right, os, prefix);
-    prefix.pop_back();
+    if (lines.size() == 1 && lines.front().second == "0") {
+        root_ = nodes_.add(lines.front().first, 0);
+        buildCodebook();
+        return NO_ERROR;
+    }
+    if (lines.empty()) {
+        buildCodebook();
+        return NO_ERROR;
+    }
+
+    // Symbols are never empty, so internal nodes are the ones without a word.
+    root_ = nodes_.add({}, 0);
+    for (const auto& [word, code] : lines) {
+        Index n = root_;
+        for (std::size_t i = 0; i < code.size(); i++) {
+            const bool last = i + 1 == code.size();
+            if (nodes_[n].wordLength != 0) {   // a leaf: an earlier code is a prefix of this one
+                nodes_.clear();
+                root_ = TreeNode::kNull;
+                return FAILED_TO_READ_FILE;
+            }
+            Index next = code[i] == '0' ? nodes_[n].left : nodes_[n].right;
+            if (next == TreeNode::kNull) {
+                next = nodes_.add(last ? std::string_view(word) : std::string_view{}, 0);
+                (code[i] == '0' ? nodes_[n].left : nodes_[n].right) = next;
+            } else if (last) {   // this code is a prefix of, or equal to, another
+                nodes_.clear();
+                root_ = TreeNode::kNull;
+                return FAILED_TO_READ_FILE;
+            }
+            n = next;
+        }
+    }
+    buildCodebook();
+    return NO_ERROR;
+}
+
+// Decodes Huffman bits into tokens
+// Pre: tree is nonempty; 'bits' is '0'/'1' with optional line breaks
+// Post: writes one token per line to 'os' (phrase leaves are split on spaces);
+//       returns NO_ERROR, FAILED_TO_READ_FILE on bad input or FAILED_TO_WRITE_FILE
+error_type HuffmanTree::decode(std::string_view bits, std::ostream& os) const {
+    if (root_ == TreeNode::kNull) return FAILED_TO_READ_FILE;
+
+    const bool loneLeaf = nodes_[root_].isLeaf();
+    Index n = root_;
+    std::string out;
+    for (char c : bits) {
+        if (c == '\n' || c == '\r') continue;
+        if (c != '0' && c != '1') return FAILED_TO_READ_FILE;
+        if (!loneLeaf) {
+            n = c == '0' ? nodes_[n].left : nodes_[n].right;
+            if (n == TreeNode::kNull) return FAILED_TO_READ_FILE;
+            if (!nodes_[n].isLeaf()) continue;
+        } else if (c != '0') {
+            return FAILED_TO_READ_FILE;
+        }
+        for (char ch : nodes_.word(n)) out.push_back(ch == ' ' ? '\n' : ch);
+        out.push_back('\n');
+        n = root_;
+    }
+    if (n != root_) return FAILED_TO_READ_FILE;   // stopped inside a code
+    os.write(out.data(), static_cast<std::streamsize>(out.size()));
+    return os.fail() ? FAILED_TO_WRITE_FILE : NO_ERROR;
 }
 
 // Encodes a sequence of tokens into Huffman bit output
@@ -129,14 +304,15 @@ void HuffmanTree::writeHeaderPreorder(const TreeNode *n, std::ostream &os, std::
 // Post: writes Huffman codes to 'os_bits', wrapping lines every 80 columns;
 //       returns NO_ERROR on success, FAILED_TO_WRITE_FILE on failure
 error_type HuffmanTree::encode(const std::vector<std::string>& tokens, std::ostream& os_bits, int wrap_cols) const {
-    if (!root_) return FAILED_TO_WRITE_FILE;
+    if (root_ == TreeNode::kNull) return FAILED_TO_WRITE_FILE;
 
     if (!os_bits.good()) return FAILED_TO_WRITE_FILE;
 
-    std::vector<std::pair<std::string, std::string>> pairs;
-    assignCodes(pairs);
-    std::map<std::string, std::string> codes;
-    codes.insert(pairs.begin(), pairs.end());
+    std::unordered_map<std::string_view, Code> codes;
+    codes.reserve(codes_.size());
+    for (std::size_t i = 0; i < codes_.size(); i++) {
+        codes.emplace(nodes_.word(leaves_[i]), codes_[i]);
+    }
 
     constexpr int WRAP = 80;
     int col = 0;
@@ -145,9 +321,9 @@ error_type HuffmanTree::encode(const std::vector<std::string>& tokens, std::ostr
         if (it == codes.end()) {
             return FAILED_TO_WRITE_FILE;
         }
-        const std::string& code = it->second;
-        for (char bit : code) {
-            os_bits.put(bit);
+        const Code code = it->second;
+        for (std::uint32_t b = code.length; b-- > 0;) {
+            os_bits.put(((code.bits >> b) & 1u) ? '1' : '0');
             if (!os_bits) return FAILED_TO_WRITE_FILE;
             if (++col == WRAP) {
                 os_bits.put('\n');
@@ -161,4 +337,49 @@ error_type HuffmanTree::encode(const std::vector<std::string>& tokens, std::ostr
         if (!os_bits) return FAILED_TO_WRITE_FILE;
     }
     return os_bits.fail() ? FAILED_TO_WRITE_FILE : NO_ERROR;
-}
\ No newline at end of file
+}
+// Encodes interned tokens into Huffman bit output
+// Pre: tree was built by buildFromIds; every id occurs as a leaf
+// Post: writes Huffman codes to 'os_bits', wrapping lines every wrap_cols columns;
+//       returns NO_ERROR on success, FAILED_TO_WRITE_FILE on failure
+error_type HuffmanTree::encode(const std::vector<TokenDictionary::Id>& ids, std::ostream& os_bits, int wrap_cols) const {
+    if (root_ == TreeNode::kNull || codeOfId_.empty()) return FAILED_TO_WRITE_FILE;
+
+    if (!os_bits.good()) return FAILED_TO_WRITE_FILE;
+
+    const std::size_t wrap = wrap_cols > 0 ? static_cast<std::size_t>(wrap_cols) : 80;
+    std::string line(wrap + 1, '\n');   // bits go in [0, wrap), the newline stays last
+    std::size_t col = 0;
+    for (TokenDictionary::Id id : ids) {
+        if (id >= codeOfId_.size() || codeOfId_[id] == TreeNode::kNull) {
+            return FAILED_TO_WRITE_FILE;
+        }
+        const Code code = codes_[codeOfId_[id]];
+        std::uint32_t left = code.length;
+        while (left > 0) {
+            const auto take = static_cast<std::uint32_t>(std::min<std::size_t>(left, wrap - col));
+            for (std::uint32_t k = 1; k <= take; k++) {
+                line[col++] = static_cast<char>('0' + ((code.bits >> (left - k)) & 1u));
+            }
+            left -= take;
+            if (col == wrap) {
+                os_bits.write(line.data(), static_cast<std::streamsize>(line.size()));
+                if (!os_bits) return FAILED_TO_WRITE_FILE;
+                col = 0;
+            }
+        }
+    }
+    if (col != 0) {
+        line[col] = '\n';
+        os_bits.write(line.data(), static_cast<std::streamsize>(col + 1));
+    }
+    return os_bits.fail() ? FAILED_TO_WRITE_FILE : NO_ERROR;
+}
+
+// Reports the tree's heap use
+// Pre: none
+// Post: returns the bytes reserved by the node arena and the codebook vectors
+std::size_t HuffmanTree::memoryBytes() const noexcept {
+    return nodes_.bytes() + leaves_.capacity() * sizeof(Index) + codes_.capacity() * sizeof(Code)
+         + codeOfId_.capacity() * sizeof(std::uint32_t);
+}
@@ -8,44 +8,124 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <istream>
 #include <ostream>
+#include <string_view>
 #include <utility>
 #include <map>
+#include <cstdint>
 #include "TreeNode.hpp"
 #include "utils.hpp"
+#include "TokenDictionary.hpp"
 
+// Summary of a code, computed from leaf counts and depths only.
+struct CodeStats {
+    std::size_t symbols = 0;             // leaves
+    std::uint64_t tokens = 0;            // sum of leaf frequencies
+    std::uint64_t totalBits = 0;         // same as encodedBits()
+    unsigned minLength = 0;              // shortest code (0 for an empty tree)
+    unsigned maxLength = 0;              // longest code
+    double averageLength = 0.0;          // bits per token
+    double entropy = 0.0;                // Shannon entropy of the frequencies, bits per token
+    std::vector<std::size_t> lengthHistogram;  // [n] = number of codes of length n
+};
 
 class HuffmanTree {
 public:
-    // Build from BST output (lexicographic vector of (word, count)).
-    static HuffmanTree buildFromCounts(const std::vector<std::pair<std::string,int>>& counts);
+    // Build from (word, count) pairs in any order. Passing them already ranked
+    // (see Ranking.hpp) lets the initial queue sort finish in one linear pass.
+    // Throws std::length_error if the counts would need a code over 64 bits.
+    static HuffmanTree buildFromCounts(const std::vector<std::pair<std::string, std::uint64_t>>& counts);
+
+    // Build from interned tokens: 'ranked' from rankIds(counts, dict). Codes
+    // are also indexed by token id so encode(ids) can look them up directly.
+    // Throws std::length_error like buildFromCounts.
+    static HuffmanTree buildFromIds(const std::vector<TokenDictionary::Id>& ranked,
+                                    const std::vector<std::uint64_t>& counts,
+                                    const TokenDictionary& dict);
+
+    // A leaf's code packed into an integer: the 'length' low bits of 'bits',
+    // first bit most significant. A tree needs codes over 64 bits only when
+    // the counts grow like Fibonacci numbers past F(66) ~ 2.7e13, which 64-bit
+    // counts can express; both builders then throw std::length_error.
+    struct Code {
+        std::uint64_t bits = 0;
+        std::uint32_t length = 0;
+
+        // '0'/'1' form, e.g. {0b011, 3} -> "011"
+        [[nodiscard]] std::string toString() const;
+    };
 
     HuffmanTree() = default;
-    ~HuffmanTree();                         // deletes the entire Huffman tree
 
-    // Build a vector of (word, code) pairs by traversing the Huffman tree
-    // (left=0, right=1; visit left before right).
+    // Packed codes of all leaves in header (pre-order) order, computed once
+    // when the tree is built; left=0, right=1, a lone leaf gets "0".
+    [[nodiscard]] const std::vector<Code>& codebook() const noexcept { return codes_; }
+
+    // Symbol of codebook()[i]: a word, or "first second" for a phrase leaf.
+    // The view stays valid until the tree is rebuilt or destroyed.
+    [[nodiscard]] std::string_view symbol(std::size_t i) const noexcept { return nodes_.word(leaves_[i]); }
+
+    // String view of the codebook: (word, code) pairs in the same order. Built
+    // on demand; writeHeader and encode do not use it.
     void assignCodes(std::vector<std::pair<std::string,std::string>>& out) const;
 
+    // Total length of the encoded token stream in bits: sum over leaves of
+    // freq x code length (a lone leaf has the 1-bit code "0").
+    [[nodiscard]] std::uint64_t encodedBits() const noexcept;
+
+    // Code quality figures: average length against entropy, length range and
+    // histogram. One pass over the packed codebook; no tree walk, no code strings.
+    [[nodiscard]] CodeStats codeStats() const;
+
     // Header writer (pre-order over leaves; "word<space>code"; newline at end).
+    // A phrase leaf (see PhraseModel) is several words separated by spaces, so
+    // readers take the last field of a line as the code and the rest as the symbol.
     error_type writeHeader(std::ostream& os) const;
 
+    // Rebuild the tree from a header written by writeHeader, replacing the
+    // current contents. Leaf frequencies are unknown and left at 0. Returns
+    // FAILED_TO_READ_FILE if a line is malformed or the codes are not prefix-free.
+    error_type readHeader(std::istream& is);
+
+    // Decode ASCII '0'/'1' (line breaks ignored) and write one token per line;
+    // a phrase leaf yields one line per word. Returns FAILED_TO_READ_FILE if
+    // the bits do not end on a leaf or lead off the tree.
+    error_type decode(std::string_view bits, std::ostream& os) const;
+
     // Encode a sequence of tokens using the codebook derived from this tree.
     // Writes ASCII '0'/'1' and wraps lines to wrap_cols (80 by default).
     error_type encode(const std::vector<std::string>& tokens,
                       std::ostream& os_bits,
                       int wrap_cols = 80) const;
 
+    // Encode interned tokens with an id-indexed codebook; the tree must come
+    // from buildFromIds. Lines wrap every wrap_cols bits.
+    error_type encode(const std::vector<TokenDictionary::Id>& ids,
+                      std::ostream& os_bits,
+                      int wrap_cols = 80) const;
+
+    // Heap bytes held by the nodes, their words and the codebook.
+    [[nodiscard]] std::size_t memoryBytes() const noexcept;
+
 private:
-    TreeNode* root_ = nullptr; // owns the full Huffman tree
+    using Index = NodeArena::Index;
+
+    NodeArena nodes_;                      // every node of the tree and the leaf words
+    Index root_ = TreeNode::kNull;
+    std::vector<Index> leaves_;            // pre-order
+    std::vector<Code> codes_;              // codes_[i] is the code of leaves_[i]
+    std::vector<std::uint32_t> codeOfId_;  // id -> index into codes_ (buildFromIds only)
 
     // helpers (decl only; defs in .cpp)
-    static void destroy(TreeNode* n) noexcept;
-    static void assignCodesDFS(const TreeNode* n,
-                               std::string& prefix,
-                               std::vector<std::pair<std::string,std::string>>& out);
-    static void writeHeaderPreorder(const TreeNode* n, std::ostream& os,
-                                    std::string& prefix);
+    void buildFromLeaves(std::vector<Index> leaves);
+    void buildCodebook();
+    void buildCodebookDFS(Index n, Code code);
+
+    // Bits leaf i of the codebook adds to the encoded stream: freq x code length.
+    [[nodiscard]] std::uint64_t leafBits(std::size_t i) const noexcept {
+        return nodes_[leaves_[i]].freq * codes_[i].length;
+    }
 };
 
 #endif //P3_PART1_HUFFMANTREE_H
\ No newline at end of file
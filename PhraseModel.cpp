@@ -0,0 +1,77 @@
+#include "PhraseModel.hpp"
+
+#include <algorithm>
+#include <string>
+
+// Learns the bigram phrases
+// pre: every id in 'ids' was interned in 'dict'
+// post: up to 'maxPhrases' pairs seen at least twice are promoted, chosen by
+//       (count desc, phrase text asc); each is interned in 'dict' as "first second"
+PhraseModel::PhraseModel(const std::vector<TokenDictionary::Id> &ids, TokenDictionary &dict,
+                         std::size_t maxPhrases) {
+    if (maxPhrases == 0 || ids.size() < 2)
+        return;
+
+    std::unordered_map<std::uint64_t, std::uint64_t> pairCounts;
+    for (std::size_t i = 0; i + 1 < ids.size(); ++i)
+        ++pairCounts[pairKey(ids[i], ids[i + 1])];
+
+    struct Candidate {
+        std::uint64_t key;
+        std::uint64_t count;
+        std::string text;
+    };
+    std::vector<Candidate> candidates;
+    for (const auto &[key, count] : pairCounts) {
+        if (count >= 2)
+            candidates.push_back({key, count, {}});
+    }
+    const auto byCount = [](const Candidate &a, const Candidate &b) { return a.count > b.count; };
+    if (candidates.size() > maxPhrases) {
+        // Keep every candidate tied with the cut-off so the text tie-break below decides.
+        std::nth_element(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(maxPhrases - 1),
+                         candidates.end(), byCount);
+        const std::uint64_t cutoff = candidates[maxPhrases - 1].count;
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                        [cutoff](const Candidate &c) { return c.count < cutoff; }),
+                         candidates.end());
+    }
+    for (auto &c : candidates) {
+        c.text = dict.word(static_cast<TokenDictionary::Id>(c.key >> 32));
+        c.text += ' ';
+        c.text += dict.word(static_cast<TokenDictionary::Id>(c.key & 0xFFFFFFFFu));
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        if (a.count != b.count)
+            return a.count > b.count;
+        return a.text < b.text;
+    });
+    if (candidates.size() > maxPhrases)
+        candidates.resize(maxPhrases);
+
+    phrases_.reserve(candidates.size());
+    for (const auto &c : candidates)
+        phrases_.emplace(c.key, dict.intern(c.text));
+}
+
+// Rewrites a token stream with the learned phrases
+// pre: none
+// post: returns 'ids' with every promoted pair, matched greedily left to right,
+//       replaced by its phrase id
+std::vector<TokenDictionary::Id> PhraseModel::segment(const std::vector<TokenDictionary::Id> &ids) const {
+    std::vector<TokenDictionary::Id> out;
+    out.reserve(ids.size());
+    std::size_t i = 0;
+    while (i < ids.size()) {
+        if (i + 1 < ids.size()) {
+            if (auto it = phrases_.find(pairKey(ids[i], ids[i + 1])); it != phrases_.end()) {
+                out.push_back(it->second);
+                i += 2;
+                continue;
+            }
+        }
+        out.push_back(ids[i]);
+        ++i;
+    }
+    return out;
+}
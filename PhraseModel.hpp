@@ -0,0 +1,36 @@
+#ifndef P3_PART1_PHRASEMODEL_H
+#define P3_PART1_PHRASEMODEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "TokenDictionary.hpp"
+
+// Word-bigram phrases for the Huffman coder. The most frequent adjacent word
+// pairs are promoted to symbols of their own: each phrase is interned in the
+// dictionary as "first second" (words never contain spaces), so it gets a
+// dense id, a Huffman leaf and a header line like any word. segment() then
+// rewrites a token stream greedily left to right, replacing every promoted
+// pair with its phrase id, and the result is counted and encoded as usual.
+class PhraseModel {
+public:
+    // Learn up to 'maxPhrases' bigrams that occur at least twice in 'ids',
+    // most frequent first; new phrase ids are interned into 'dict'.
+    PhraseModel(const std::vector<TokenDictionary::Id> &ids, TokenDictionary &dict, std::size_t maxPhrases);
+
+    // Greedy rewrite of 'ids' using the learned phrases.
+    [[nodiscard]] std::vector<TokenDictionary::Id> segment(const std::vector<TokenDictionary::Id> &ids) const;
+
+    [[nodiscard]] std::size_t size() const noexcept { return phrases_.size(); }
+
+private:
+    std::unordered_map<std::uint64_t, TokenDictionary::Id> phrases_;   // pairKey(first, second) -> phrase id
+
+    static std::uint64_t pairKey(TokenDictionary::Id first, TokenDictionary::Id second) noexcept {
+        return (static_cast<std::uint64_t>(first) << 32) | second;
+    }
+};
+
+#endif //P3_PART1_PHRASEMODEL_H
@@ -5,28 +5,29 @@
 #include "PriorityQueue.hpp"
 #include <algorithm>
 
-// Order for queue items, higher frequency wins, tie by lexicographically smaller keyWord()
-// pre: a and b are non-null pointers to valid TreeNode objects
+// Order for queue items, higher frequency wins, tie by lexicographically smaller key word
+// pre: a and b are valid indices into arena_
 // post: Returns true if 'a' should come before 'b' in the queue's sorted order
-bool PriorityQueue::higherPriority(const TreeNode *a, const TreeNode *b) noexcept {
-    if (a->freq > b->freq)
+bool PriorityQueue::higherPriority(Index a, Index b) const noexcept {
+    if (arena_[a].freq > arena_[b].freq)
         return true;
-    else if (a->freq < b->freq)
+    else if (arena_[a].freq < arena_[b].freq)
         return false;
     else
-        return a-> keyWord() < b->keyWord();
+        return arena_.word(a) < arena_.word(b);   // a merged node's word is its smallest leaf word
 }
 
 // constructs an initial vector of nodes by higherPriority
-// pre: 'nodes' may be empty, all pointers in 'nodes' are valid TreeNode*
+// pre: 'nodes' may be empty, all entries of 'nodes' are valid indices into 'arena'
 // post: items_ holds the input nodes sorted in non-increasing priority
-PriorityQueue::PriorityQueue(std::vector<TreeNode *> nodes) : items_(std::move(nodes)) {
+PriorityQueue::PriorityQueue(const NodeArena &arena, std::vector<Index> nodes)
+    : arena_(arena), items_(std::move(nodes)) {
     const std::size_t n = items_.size();
     if (n < 2 )
         return;
 
     for (std::size_t i = 1; i < n; ++i) {
-        TreeNode* key = items_[i];
+        Index key = items_[i];
         std::size_t j = i;
         while (j > 0 && !higherPriority(items_[j - 1], key)) {
             items_[j] = items_[j - 1];
@@ -52,21 +53,21 @@ bool PriorityQueue::empty() const noexcept {
 
 // Peeks at the minimum-priority element without removing
 // pre: none
-// post: returns pointer to min element if not empty, else nullptr
-TreeNode* PriorityQueue::findMin() const noexcept {
+// post: returns the min element if not empty, else TreeNode::kNull
+PriorityQueue::Index PriorityQueue::findMin() const noexcept {
     if (items_.empty())
-        return nullptr;
+        return TreeNode::kNull;
     return items_.back();
 }
 
 // removes and returns the minimum-priority element
 // pre: none
-// post: if non-empty, returns previous min and queue size decreases by 1, else nullptr
-TreeNode* PriorityQueue::extractMin() noexcept {
+// post: if non-empty, returns previous min and queue size decreases by 1, else TreeNode::kNull
+PriorityQueue::Index PriorityQueue::extractMin() noexcept {
     if (items_.empty())
-        return nullptr;
+        return TreeNode::kNull;
 
-    TreeNode* min = items_.back();
+    Index min = items_.back();
     items_.pop_back();
     return min;
 }
@@ -80,9 +81,9 @@ void PriorityQueue::deleteMin() noexcept {
 }
 
 // Inserts 'node' into the queue while maintaining sorted order
-// pre: 'node' is a valid TreeNode*, Current items_ are sorted by higherPriority
+// pre: 'node' is a valid index into arena_, Current items_ are sorted by higherPriority
 // post: 'node' is placed so that items_ remains sorted, size increases by 1
-void PriorityQueue::insert(TreeNode* node) {
+void PriorityQueue::insert(Index node) {
     std::size_t position = 0;
     const std::size_t n = items_.size();
 
@@ -94,7 +95,7 @@ void PriorityQueue::insert(TreeNode* node) {
         }
     }
 
-    items_.push_back(nullptr);
+    items_.push_back(TreeNode::kNull);
     for (std::size_t i = items_.size() - 1; i > position; --i) {
         items_[i] = items_[i - 1];
     }
@@ -120,8 +121,8 @@ bool PriorityQueue::isSorted() const {
 // post: Queue contents are written to 'os'. Queue remains unchanged
 void PriorityQueue::print(std::ostream& os) const {
     os << "Priority Queue size:" << items_.size() << "\n";
-    for (const auto* node : items_) {
-        os << " (" << node->keyWord() << ", " << node->freq << ")\n";
+    for (Index node : items_) {
+        os << " (" << arena_.word(node) << ", " << arena_[node].freq << ")\n";
     }
 }
 
@@ -0,0 +1,61 @@
+#include "Ranking.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+// Ranking order, higher count wins, tie by lexicographically smaller word
+// pre: none
+// post: returns true if 'a' should be listed before 'b'
+bool higherFrequency(const std::pair<std::string, std::uint64_t> &a,
+                     const std::pair<std::string, std::uint64_t> &b) noexcept {
+    if (a.second != b.second)
+        return a.second > b.second;
+    return a.first < b.first;
+}
+
+// Sorts the (word, count) vector once into ranking order
+// pre: words in 'counts' are distinct
+// post: 'counts' is ordered by higherFrequency
+void rankByFrequency(std::vector<std::pair<std::string, std::uint64_t>> &counts) {
+    std::sort(counts.begin(), counts.end(), higherFrequency);
+}
+
+// Writes the .freq listing
+// pre: 'ranked' is ordered by higherFrequency, 'os' is open for writing
+// post: one line per entry is written; returns NO_ERROR or FAILED_TO_WRITE_FILE
+error_type writeFrequencies(std::ostream &os,
+                            const std::vector<std::pair<std::string, std::uint64_t>> &ranked) {
+    for (const auto &[word, count] : ranked) {
+        os << std::setw(10) << count << ' ' << word << '\n';
+    }
+    return os.fail() ? FAILED_TO_WRITE_FILE : NO_ERROR;
+}
+
+// Ranks interned ids by their counts
+// pre: counts.size() <= dict.size()
+// post: returns every id with counts[id] > 0, ordered by (count desc, word asc)
+std::vector<TokenDictionary::Id> rankIds(const std::vector<std::uint64_t> &counts, const TokenDictionary &dict) {
+    std::vector<TokenDictionary::Id> ranked;
+    ranked.reserve(counts.size());
+    for (std::size_t id = 0; id < counts.size(); ++id) {
+        if (counts[id] > 0)
+            ranked.push_back(static_cast<TokenDictionary::Id>(id));
+    }
+    std::sort(ranked.begin(), ranked.end(), [&](TokenDictionary::Id a, TokenDictionary::Id b) {
+        if (counts[a] != counts[b])
+            return counts[a] > counts[b];
+        return dict.word(a) < dict.word(b);
+    });
+    return ranked;
+}
+
+// Writes the .freq listing from ranked ids
+// pre: 'ranked' comes from rankIds(counts, dict), 'os' is open for writing
+// post: one line per id is written; returns NO_ERROR or FAILED_TO_WRITE_FILE
+error_type writeFrequencies(std::ostream &os, const std::vector<TokenDictionary::Id> &ranked,
+                            const std::vector<std::uint64_t> &counts, const TokenDictionary &dict) {
+    for (TokenDictionary::Id id : ranked) {
+        os << std::setw(10) << counts[id] << ' ' << dict.word(id) << '\n';
+    }
+    return os.fail() ? FAILED_TO_WRITE_FILE : NO_ERROR;
+}
@@ -0,0 +1,35 @@
+#ifndef P3_PART1_RANKING_H
+#define P3_PART1_RANKING_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils.hpp"
+#include "TokenDictionary.hpp"
+
+// Ranking stage shared by the .freq writer and Huffman construction.
+// The order is the PriorityQueue order: higher count first, ties broken by
+// the lexicographically smaller word.
+
+// True if 'a' ranks before 'b'.
+bool higherFrequency(const std::pair<std::string, std::uint64_t> &a,
+                     const std::pair<std::string, std::uint64_t> &b) noexcept;
+
+// Sort 'counts' in place into ranking order.
+void rankByFrequency(std::vector<std::pair<std::string, std::uint64_t>> &counts);
+
+// Write ranked counts as "<count right-aligned in 10 columns> <word>" lines.
+error_type writeFrequencies(std::ostream &os,
+                            const std::vector<std::pair<std::string, std::uint64_t>> &ranked);
+
+// Interned form: ids with a non-zero counts[id], in ranking order.
+std::vector<TokenDictionary::Id> rankIds(const std::vector<std::uint64_t> &counts, const TokenDictionary &dict);
+
+// Same .freq format for ranked ids.
+error_type writeFrequencies(std::ostream &os, const std::vector<TokenDictionary::Id> &ranked,
+                            const std::vector<std::uint64_t> &counts, const TokenDictionary &dict);
+
+#endif //P3_PART1_RANKING_H
@@ -9,94 +9,127 @@
 #include <fstream>
 
 #include "utils.hpp"
+#include "Tokenizer.hpp"
+#include "BlockReader.hpp"
 // Constructor
 //pre: inputPath is a valid filesystem path
 //post: Scanner object is initialized with inputPath stored in inputPath_
-Scanner::Scanner(std::filesystem::path inputPath) : inputPath_(std::move(inputPath)) {}
+template <typename Rules>
+BasicScanner<Rules>::BasicScanner(std::filesystem::path inputPath) : inputPath_(std::move(inputPath)) {}
 
-//Tokenize: Reads words from the file into a vector
-//pre: 'words' is a valid reference to a vector<string>, inputPath_ must be initialized
-//post: If the file exists and can be opened, 'words' contains all tokens
-error_type Scanner::tokenize(std::vector<std::string>& words) {
+template <typename Rules>
+BasicScanner<Rules>::BasicScanner(BasicScanner&&) noexcept = default;
+
+// Destructor
+//pre: none
+//post: an input opened by open() but never scanned is closed
+template <typename Rules>
+BasicScanner<Rules>::~BasicScanner() = default;
+
+// open: Opens the input ahead of tokenize()
+//pre: inputPath_ must be initialized ("-" means standard input)
+//post: on NO_ERROR the input is open and held for the next tokenize() call.
+//      The file is opened once; directoryExists is only consulted when that
+//      open fails, to tell a missing directory from a missing file
+template <typename Rules>
+error_type BasicScanner<Rules>::open() {
+    reader_ = std::make_unique<BlockReader>();
+    const error_type status = inputPath_ == "-" ? reader_->openStdin() : reader_->open(inputPath_);
+    if (status == NO_ERROR) {
+        return NO_ERROR;
+    }
+    reader_.reset();
     const std::filesystem::path parent = inputPath_.parent_path();
-    if (!parent.empty()) {
-        if (auto status = directoryExists(parent.string()); status != NO_ERROR) {
-            return status;
+    if (status == FILE_NOT_FOUND && !parent.empty()) {
+        if (auto dirStatus = directoryExists(parent.string()); dirStatus != NO_ERROR) {
+            return dirStatus;
         }
     }
-    if (auto status = regularFileExistsAndIsAvailable(inputPath_.string()); status != NO_ERROR) {
-        return status;
-        }
+    return status;
+}
 
-    std::ifstream in(inputPath_, std::ios::binary);
-    if (!in.is_open()) {
-        return UNABLE_TO_OPEN_FILE;
-    }
+// open (overload): Points the scanner at another input and opens it
+//pre: 'inputPath' is a filesystem path or "-"
+//post: inputPath_ is 'inputPath'; see open()
+template <typename Rules>
+error_type BasicScanner<Rules>::open(std::filesystem::path inputPath) {
+    inputPath_ = std::move(inputPath);
+    return open();
+}
+
+//Tokenize: Reads words from the file into a vector
+//pre: 'words' is a valid reference to a vector<string>, inputPath_ must be initialized
+//post: If the file exists and can be opened, 'words' contains all tokens
+template <typename Rules>
+error_type BasicScanner<Rules>::tokenize(std::vector<std::string>& words) {
     words.clear();
-    while (true) {
-        std::string word = readWord(in);
-        if (word.empty()) break;
-        words.push_back(std::move(word));
+    auto sink = [&words](std::string& word) { words.push_back(std::move(word)); };
+    return scan(sink);
+}
 
-    }
-    return NO_ERROR;
+//tokenize (interning): Reads words from the file as dense token ids
+//pre: 'ids' and 'dict' are valid references, inputPath_ must be initialized
+//post: If the file exists and can be opened, 'ids' holds one id per token and
+//      every distinct word has been interned in 'dict'
+template <typename Rules>
+error_type BasicScanner<Rules>::tokenize(std::vector<TokenDictionary::Id>& ids, TokenDictionary& dict) {
+    ids.clear();
+    auto sink = [&ids, &dict](std::string& word) { ids.push_back(dict.intern(word)); };
+    return scan(sink);
+}
+
+//tokenize (streaming): Reads words from the file and hands each one to a callback
+//pre: 'onToken' is callable, inputPath_ must be initialized
+//post: If the file exists and can be opened, 'onToken' has been called once per token in order;
+//      the callback may move from its argument
+template <typename Rules>
+error_type BasicScanner<Rules>::tokenize(const std::function<void(std::string&)>& onToken) {
+    return scan(onToken);
 }
 
 //tokenize (overload): Read words and writes them to an output file.
 //pre: 'words' is a valid vector reference, 'outputFile' is a valid filesystem path.
 //post: On success, 'words' is populated, and 'outputFile' is created and filled with one word per line.
 //      Returns NO_ERROR on success, or an appropriate error_type otherwise
-error_type Scanner::tokenize(std::vector<std::string>& words,
+template <typename Rules>
+error_type BasicScanner<Rules>::tokenize(std::vector<std::string>& words,
                     const std::filesystem::path& outputFile) {
     if(auto status = this->tokenize(words); status != NO_ERROR) {
         return status;
     }
-    if(auto status = canOpenForWriting(outputFile.string()); status != NO_ERROR) {
-        return status;
-    }
     if (auto status = writeVectorToFile(outputFile.string(), words); status != NO_ERROR) {
         return status;
     }
     return NO_ERROR;
 }
 
-// readWord: Reads the next word-like token from the input stream
-//pre: 'in' is an open input stream
-//post: returns the next lowercase word consisting of letters and valid apostrophes,
-//      if no more valid tokens are available, returns an empty string
-std::string Scanner::readWord(std::istream &in) {
-    std::string token;
-    int c_int;
-
-    while ((c_int = in.get()) != EOF) {
-        unsigned char ch = static_cast<unsigned char>(c_int);
-        if (std::isalpha(ch) && ch < 128) {
-            token.push_back(static_cast<char>(std::tolower(ch)));
-            break;
+// scan: Runs the whole input file through the tokenizer
+//pre: inputPath_ must be initialized ("-" reads standard input), 'sink' is callable with std::string&
+//post: If the file exists and can be opened, 'sink' has received every token in order;
+//      returns NO_ERROR or the error found while opening the file. An input
+//      opened by open() is used (and released) instead of opening it again
+template <typename Rules>
+template <typename Sink>
+error_type BasicScanner<Rules>::scan(Sink& sink) {
+    // Blocks are read (and inflated, for .gz input) on a background thread
+    // while this one tokenizes.
+    if (!reader_) {
+        if (auto status = open(); status != NO_ERROR) {
+            return status;
         }
     }
+    const std::unique_ptr<BlockReader> reader = std::move(reader_);
 
-    if (token.empty()) return {};
-
-    while ((c_int = in.peek()) != EOF) {
-        unsigned char ch = static_cast<unsigned char>(c_int);
-        if (std::isalpha(ch) && ch < 128) {
-            in.get();
-            token.push_back(static_cast<char>(std::tolower(ch)));
-            continue;
-        }
-        if (ch == '\'') {
-            in.get();
-            int next = in.peek();
-            if (next != EOF) {
-                unsigned char nch = static_cast<unsigned char>(next);
-                if (std::isalpha(nch) && nch < 128) {
-                    token.push_back('\'');
-                }
-            }
-            break;
-        }
-        break;
+    Tokenizer<Rules> tokenizer;
+    std::string_view block;
+    while (reader->next(block)) {
+        tokenizer.feed(block.data(), block.data() + block.size(), sink);
     }
-    return token;
-}
\ No newline at end of file
+    tokenizer.finish(sink);
+    return reader->status();
+}
+
+template class BasicScanner<AsciiWordRules>;
+template class BasicScanner<AlnumWordRules>;
+template class BasicScanner<HyphenWordRules>;
+template class BasicScanner<Utf8WordRules>;
@@ -7,30 +7,69 @@
 #include <string>
 #include <vector>
 #include <filesystem>
+#include <functional>
+#include <memory>
 
 #include "utils.hpp"
+#include "TokenDictionary.hpp"
+#include "TokenRules.hpp"
 
-class Scanner {
+class BlockReader;
+
+// Reads a file and splits it into words according to 'Rules' (see TokenRules.hpp).
+// The rule set is fixed at compile time; Scanner is the project's default rules.
+template <typename Rules>
+class BasicScanner {
 public:
-    explicit Scanner(std::filesystem::path inputPath);
+    // "-" reads standard input; tokens are delivered as input arrives.
+    explicit BasicScanner(std::filesystem::path inputPath);
+    BasicScanner(BasicScanner&&) noexcept;
+    ~BasicScanner();
+
+    // Open the input now rather than in the first tokenize() call, so callers
+    // can report a missing or unreadable file before creating any output. The
+    // handle is kept and consumed by the next tokenize(). Returns FILE_NOT_FOUND,
+    // DIR_NOT_FOUND, UNABLE_TO_OPEN_FILE, UNSUPPORTED_FILE_FORMAT,
+    // INSUFFICIENT_MEMORY or NO_ERROR.
+    error_type open();
+
+    // Switch to 'inputPath' and open it (see open()).
+    error_type open(std::filesystem::path inputPath);
 
     // Tokenize into memory (according to the Rules in this section).
     error_type tokenize(std::vector<std::string>& words);
 
+    // Streaming form: calls 'onToken' once per token, in input order, without
+    // keeping the token list in memory.
+    error_type tokenize(const std::function<void(std::string&)>& onToken);
+
+    // Interning form: appends one id per token to 'ids', interning new words
+    // into 'dict'. 'ids' is cleared first; 'dict' may already hold words.
+    error_type tokenize(std::vector<TokenDictionary::Id>& ids, TokenDictionary& dict);
+
     // Tokenize and also write one token per line to 'outputFile' (e.g., <base>.tokens).
     // This overload should internally call the in‑memory tokenize() to avoid duplicate logic.
     error_type tokenize(std::vector<std::string>& words,
                         const std::filesystem::path& outputFile);
 
-    ~Scanner() = default;
-
 private:
-    // Read the next token from 'in'. Returns empty string when no more tokens.
-    // Follows the project’s tokenization rules: letters a–z with optional internal apostrophes;
-    // digits, punctuation, hyphens/dashes, whitespace, and non‑ASCII are separators.
-    static std::string readWord(std::istream& in);
+    // Opens the input and feeds it block by block through a Tokenizer<Rules>,
+    // handing each finished token to 'sink'.
+    template <typename Sink>
+    error_type scan(Sink& sink);
 
     std::filesystem::path inputPath_;
+    std::unique_ptr<BlockReader> reader_;   // opened by open(), not yet consumed
 };
 
-#endif //IMPLEMENTATION_FILETOWORDS_HPP
\ No newline at end of file
+// Instantiated in Scanner.cpp.
+extern template class BasicScanner<AsciiWordRules>;
+extern template class BasicScanner<AlnumWordRules>;
+extern template class BasicScanner<HyphenWordRules>;
+extern template class BasicScanner<Utf8WordRules>;
+
+// Letters a–z with optional internal apostrophes; digits, punctuation,
+// hyphens/dashes, whitespace, and non‑ASCII are separators.
+using Scanner = BasicScanner<AsciiWordRules>;
+
+#endif //IMPLEMENTATION_FILETOWORDS_HPP
@@ -0,0 +1,102 @@
+#include "SpaceSaving.hpp"
+
+#include <algorithm>
+
+// Constructor
+// pre: capacity > 0
+// post: an empty counter able to track 'capacity' distinct words
+SpaceSaving::SpaceSaving(std::size_t capacity) : capacity_(capacity == 0 ? 1 : capacity) {
+    entries_.reserve(capacity_);
+    heap_.reserve(capacity_);
+    heapPos_.reserve(capacity_);
+    slots_.reserve(capacity_);
+}
+
+// Counts one occurrence of 'word'
+// pre: none
+// post: 'word' is tracked; if the counter was full the minimum-count word was evicted
+void SpaceSaving::insert(std::string_view word) {
+    ++total_;
+    if (auto it = slots_.find(word); it != slots_.end()) {
+        const std::size_t slot = it->second;
+        ++entries_[slot].count;
+        siftDown(heapPos_[slot]);
+        return;
+    }
+
+    if (entries_.size() < capacity_) {
+        const std::size_t slot = entries_.size();
+        entries_.push_back({std::string(word), 1, 0});
+        heap_.push_back(slot);
+        heapPos_.push_back(heap_.size() - 1);
+        slots_.emplace(entries_[slot].word, slot);
+        siftUp(heap_.size() - 1);
+        return;
+    }
+
+    // Replace the current minimum in place; its count only grows, so it sinks.
+    const std::size_t slot = heap_.front();
+    Entry &victim = entries_[slot];
+    slots_.erase(victim.word);
+    victim.error = victim.count;
+    victim.count += 1;
+    victim.word.assign(word);
+    slots_.emplace(victim.word, slot);
+    siftDown(0);
+}
+
+// Collects the heaviest tracked words
+// pre: none
+// post: 'out' holds min(k, size()) entries in ranking order
+void SpaceSaving::topK(std::size_t k, std::vector<Entry> &out) const {
+    out.assign(entries_.begin(), entries_.end());
+    const auto ranksBefore = [](const Entry &a, const Entry &b) {
+        if (a.count != b.count)
+            return a.count > b.count;
+        return a.word < b.word;
+    };
+    k = std::min(k, out.size());
+    std::partial_sort(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(k), out.end(), ranksBefore);
+    out.resize(k);
+}
+
+// Moves heap_[pos] toward the root while it is smaller than its parent
+// pre: pos < heap_.size()
+// post: heap property holds on the path from pos to the root
+void SpaceSaving::siftUp(std::size_t pos) noexcept {
+    while (pos > 0) {
+        const std::size_t parent = (pos - 1) / 2;
+        if (entries_[heap_[parent]].count <= entries_[heap_[pos]].count)
+            break;
+        swapHeap(pos, parent);
+        pos = parent;
+    }
+}
+
+// Moves heap_[pos] toward the leaves while a child is smaller
+// pre: pos < heap_.size()
+// post: heap property holds in the subtree rooted at pos
+void SpaceSaving::siftDown(std::size_t pos) noexcept {
+    const std::size_t n = heap_.size();
+    while (true) {
+        const std::size_t l = 2 * pos + 1;
+        const std::size_t r = l + 1;
+        std::size_t smallest = pos;
+        if (l < n && entries_[heap_[l]].count < entries_[heap_[smallest]].count)
+            smallest = l;
+        if (r < n && entries_[heap_[r]].count < entries_[heap_[smallest]].count)
+            smallest = r;
+        if (smallest == pos)
+            return;
+        swapHeap(pos, smallest);
+        pos = smallest;
+    }
+}
+
+// pre: a, b < heap_.size()
+// post: heap_ positions a and b are exchanged and heapPos_ is kept in sync
+void SpaceSaving::swapHeap(std::size_t a, std::size_t b) noexcept {
+    std::swap(heap_[a], heap_[b]);
+    heapPos_[heap_[a]] = a;
+    heapPos_[heap_[b]] = b;
+}
@@ -0,0 +1,56 @@
+#ifndef P3_PART1_SPACESAVING_H
+#define P3_PART1_SPACESAVING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Fixed-memory heavy-hitter counter (Metwally et al. "space-saving").
+// Tracks at most 'capacity' words. When a new word arrives and every slot is
+// taken, the word with the smallest count is evicted and the newcomer inherits
+// that count plus one. A reported count never underestimates the true count
+// and overestimates it by at most the reported error, so any word whose true
+// count exceeds totalInserted / capacity is guaranteed to be tracked.
+class SpaceSaving {
+public:
+    struct Entry {
+        std::string word;
+        std::uint64_t count = 0;   // upper bound on the true count
+        std::uint64_t error = 0;   // count - error is a lower bound on the true count
+    };
+
+    explicit SpaceSaving(std::size_t capacity);
+
+    void insert(std::string_view word);
+
+    // The k tracked words with the highest counts, in ranking order
+    // (count desc, word asc).
+    void topK(std::size_t k, std::vector<Entry> &out) const;
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+    [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
+    [[nodiscard]] std::size_t totalInserted() const noexcept { return total_; }
+
+private:
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+
+    std::size_t capacity_;
+    std::size_t total_ = 0;
+    std::vector<Entry> entries_;        // slot storage
+    std::vector<std::size_t> heap_;     // slot indices, min-heap on count
+    std::vector<std::size_t> heapPos_;  // slot index -> position in heap_
+    std::unordered_map<std::string, std::size_t, Hash, std::equal_to<>> slots_;
+
+    void siftUp(std::size_t pos) noexcept;
+    void siftDown(std::size_t pos) noexcept;
+    void swapHeap(std::size_t a, std::size_t b) noexcept;
+};
+
+#endif //P3_PART1_SPACESAVING_H
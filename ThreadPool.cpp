@@ -0,0 +1,45 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+// Constructor
+// pre: none
+// post: 'threads' workers (or one per hardware thread if 0) wait for tasks
+ThreadPool::ThreadPool(std::size_t threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+        workers_.emplace_back(&ThreadPool::run, this);
+}
+
+// Destructor
+// pre: none
+// post: every queued task has run and all workers are joined
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (std::thread &worker : workers_)
+        worker.join();
+}
+
+// Worker thread: runs tasks in queue order until stopped and drained
+// pre: none
+// post: returns once stop_ is set and the queue is empty
+void ThreadPool::run() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+            if (tasks_.empty())
+                return;
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
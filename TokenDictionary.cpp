@@ -0,0 +1,45 @@
+#include "TokenDictionary.hpp"
+
+// Interns a word
+// pre: fewer than 2^32 - 1 distinct words have been interned
+// post: returns the id of 'word'; a new word receives id size() - 1
+TokenDictionary::Id TokenDictionary::intern(std::string_view word) {
+    if (auto it = ids_.find(word); it != ids_.end())
+        return it->second;
+    const Id id = static_cast<Id>(words_.size());
+    const std::string &stored = words_.emplace_back(word);
+    ids_.emplace(stored, id);
+    return id;
+}
+
+// Looks up a word without interning it
+// pre: none
+// post: returns the id of 'word' if it has been interned, else nullopt
+std::optional<TokenDictionary::Id> TokenDictionary::find(std::string_view word) const noexcept {
+    if (auto it = ids_.find(word); it != ids_.end())
+        return it->second;
+    return std::nullopt;
+}
+
+// Counts token ids into a flat array
+// pre: every id in 'ids' is < vocabularySize
+// post: returns a vector of size vocabularySize with the occurrences of each id
+std::vector<std::uint64_t> countTokens(const std::vector<TokenDictionary::Id> &ids, std::size_t vocabularySize) {
+    std::vector<std::uint64_t> counts(vocabularySize, 0);
+    for (TokenDictionary::Id id : ids)
+        ++counts[id];
+    return counts;
+}
+
+// Writes the .tokens listing
+// pre: every id in 'ids' was interned in 'dict', 'os' is open for writing
+// post: one word per line is written; returns NO_ERROR or FAILED_TO_WRITE_FILE
+error_type writeTokens(std::ostream &os, const std::vector<TokenDictionary::Id> &ids,
+                       const TokenDictionary &dict) {
+    for (TokenDictionary::Id id : ids) {
+        os << dict.word(id) << '\n';
+        if (!os)
+            return FAILED_TO_WRITE_FILE;
+    }
+    return NO_ERROR;
+}
@@ -0,0 +1,47 @@
+#ifndef P3_PART1_TOKENDICTIONARY_H
+#define P3_PART1_TOKENDICTIONARY_H
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "utils.hpp"
+
+// String interning for the pipeline. Each distinct word gets a dense 32-bit id
+// in first-occurrence order (0, 1, 2, ...), so later stages can count, build
+// and encode over integer arrays and only turn ids back into text when they
+// write .tokens, .freq and .hdr.
+class TokenDictionary {
+public:
+    using Id = std::uint32_t;
+
+    TokenDictionary() = default;
+    TokenDictionary(const TokenDictionary &) = delete;             // ids_ views into words_
+    TokenDictionary &operator=(const TokenDictionary &) = delete;
+
+    // Id of 'word', assigning the next free id if it has not been seen.
+    Id intern(std::string_view word);
+
+    [[nodiscard]] std::optional<Id> find(std::string_view word) const noexcept;
+
+    [[nodiscard]] const std::string &word(Id id) const { return words_[id]; }
+    [[nodiscard]] std::size_t size() const noexcept { return words_.size(); }
+
+private:
+    std::deque<std::string> words_;                  // id -> word; deque keeps addresses stable
+    std::unordered_map<std::string_view, Id> ids_;   // word -> id, keys view into words_
+};
+
+// Flat frequency table: counts[id] = occurrences of id in 'ids'.
+std::vector<std::uint64_t> countTokens(const std::vector<TokenDictionary::Id> &ids, std::size_t vocabularySize);
+
+// Write the token stream as text, one word per line (the .tokens format).
+error_type writeTokens(std::ostream &os, const std::vector<TokenDictionary::Id> &ids,
+                       const TokenDictionary &dict);
+
+#endif //P3_PART1_TOKENDICTIONARY_H
@@ -0,0 +1,88 @@
+#ifndef P3_PART1_TOKENRULES_H
+#define P3_PART1_TOKENRULES_H
+
+#include <array>
+#include <cstdint>
+
+// Tokenizer rule sets. A rule set is a stateless struct that classifies single
+// bytes; BasicScanner<Rules> turns it into 256-entry constexpr tables, so
+// choosing a rule set costs nothing at run time.
+//
+// Every rule set provides:
+//   static constexpr bool isLetter(unsigned char)   -- byte belongs in a word
+//   static constexpr bool isJoiner(unsigned char)   -- byte may sit between letters
+//   static constexpr unsigned char fold(unsigned char) -- case folding for letters
+//   static constexpr bool kJoinerEndsToken
+//       true:  "don't" -> "don'", "t" (the project's original rule)
+//       false: "don't" -> "don't"
+//   static constexpr bool kUtf8
+//       false: every byte is classified on its own (bytes >= 0x80 via the tables)
+//       true:  bytes >= 0x80 are decoded as UTF-8 and classified per code point
+//              (UnicodeTables.hpp); the byte tables only ever see ASCII
+
+enum class CharClass : std::uint8_t {
+    Separator,
+    Letter,
+    Joiner,
+};
+
+// The project rules: ASCII letters a-z, lowercased. An apostrophe directly
+// followed by a letter is kept and ends the token; digits, punctuation,
+// hyphens, whitespace and non-ASCII bytes are separators.
+struct AsciiWordRules {
+    static constexpr bool kJoinerEndsToken = true;
+    static constexpr bool kUtf8 = false;
+
+    static constexpr bool isLetter(unsigned char c) noexcept {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+    static constexpr bool isJoiner(unsigned char c) noexcept { return c == '\''; }
+    static constexpr unsigned char fold(unsigned char c) noexcept {
+        return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+    }
+};
+
+// Project rules with digits kept as word characters ("mp3", "2025").
+struct AlnumWordRules : AsciiWordRules {
+    static constexpr bool isLetter(unsigned char c) noexcept {
+        return AsciiWordRules::isLetter(c) || (c >= '0' && c <= '9');
+    }
+};
+
+// Hyphenated and contracted words stay whole: "rock-n-roll", "don't".
+struct HyphenWordRules : AsciiWordRules {
+    static constexpr bool kJoinerEndsToken = false;
+
+    static constexpr bool isJoiner(unsigned char c) noexcept { return c == '\'' || c == '-'; }
+};
+
+// Project rules extended to UTF-8 text: accented, Greek, Cyrillic, CJK, ...
+// letters are words too and are case-folded; U+2019 counts as an apostrophe.
+// On pure-ASCII input the output is identical to AsciiWordRules.
+struct Utf8WordRules : AsciiWordRules {
+    static constexpr bool kUtf8 = true;
+};
+
+// Compile-time classification and case-folding tables for a rule set.
+template <typename Rules>
+struct CharTables {
+    static constexpr std::array<CharClass, 256> classes = [] {
+        std::array<CharClass, 256> t{};
+        for (unsigned c = 0; c < 256; ++c) {
+            const auto b = static_cast<unsigned char>(c);
+            t[c] = Rules::isLetter(b) ? CharClass::Letter
+                 : Rules::isJoiner(b) ? CharClass::Joiner
+                 : CharClass::Separator;
+        }
+        return t;
+    }();
+
+    static constexpr std::array<char, 256> folded = [] {
+        std::array<char, 256> t{};
+        for (unsigned c = 0; c < 256; ++c)
+            t[c] = static_cast<char>(Rules::fold(static_cast<unsigned char>(c)));
+        return t;
+    }();
+};
+
+#endif //P3_PART1_TOKENRULES_H
@@ -0,0 +1,238 @@
+#ifndef P3_PART1_TOKENIZER_H
+#define P3_PART1_TOKENIZER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "TokenRules.hpp"
+#include "UnicodeTables.hpp"
+
+// Incremental tokenizer over raw byte buffers. Input may be split at any byte
+// boundary: a word, a joiner waiting for its next byte, or a partially read
+// UTF-8 sequence is carried over to the next feed() call, so callers can hand
+// over file blocks as they arrive.
+// 'sink' is any callable taking std::string&; it may move from its argument.
+template <typename Rules>
+class Tokenizer {
+public:
+    template <typename Sink>
+    void feed(const char *p, const char *end, Sink &sink) {
+        if constexpr (!Rules::kUtf8) {
+            feedBytes(p, end, sink);
+        } else {
+            // ASCII fast path: runs without high bytes go through the same
+            // table loop as the byte rules; only multi-byte sequences are decoded.
+            while (p != end) {
+                if (pendingLength_ == 0 && static_cast<unsigned char>(*p) < 0x80) {
+                    const char *ascii = skipAscii(p, end);
+                    feedBytes(p, ascii, sink);
+                    p = ascii;
+                } else {
+                    p = feedMultibyte(p, end, sink);
+                }
+            }
+        }
+    }
+
+    // Flush the word still open at end of input (a trailing joiner or an
+    // incomplete UTF-8 sequence is dropped).
+    template <typename Sink>
+    void finish(Sink &sink) {
+        joinerPending_ = false;
+        pendingLength_ = 0;
+        if (!token_.empty())
+            emit(sink);
+    }
+
+private:
+    std::string token_;
+    bool joinerPending_ = false;
+    char joiner_ = 0;
+
+    // UTF-8 sequence being assembled (kUtf8 only).
+    char pending_[4] = {};
+    std::uint8_t pendingLength_ = 0;
+    std::uint8_t expectedLength_ = 0;
+
+    template <typename Sink>
+    void emit(Sink &sink) {
+        sink(token_);
+        token_.clear();
+    }
+
+    // Byte-table state machine. With kUtf8 it only ever sees ASCII.
+    template <typename Sink>
+    void feedBytes(const char *p, const char *end, Sink &sink) {
+        constexpr const auto &classes = CharTables<Rules>::classes;
+        constexpr const auto &folded = CharTables<Rules>::folded;
+
+        while (p != end) {
+            if (token_.empty()) {
+                // Between words: skip separators and stray joiners.
+                while (p != end && classes[static_cast<unsigned char>(*p)] != CharClass::Letter)
+                    ++p;
+                if (p == end)
+                    return;
+            } else if (joinerPending_) {
+                // Previous byte was a joiner; it is kept only if a letter follows.
+                joinerPending_ = false;
+                if (classes[static_cast<unsigned char>(*p)] != CharClass::Letter) {
+                    emit(sink);
+                    ++p;
+                    continue;
+                }
+                token_.push_back(joiner_);
+                if constexpr (Rules::kJoinerEndsToken)
+                    emit(sink);
+            }
+
+            // Inside a word: consume the run of letters.
+            while (p != end && classes[static_cast<unsigned char>(*p)] == CharClass::Letter) {
+                token_.push_back(folded[static_cast<unsigned char>(*p)]);
+                ++p;
+            }
+            if (p == end)
+                return;
+            if (classes[static_cast<unsigned char>(*p)] == CharClass::Joiner) {
+                joinerPending_ = true;
+                joiner_ = *p;
+            } else {
+                emit(sink);
+            }
+            ++p;
+        }
+    }
+
+    // First byte >= 0x80 in [p, end), or end. Checks eight bytes per step.
+    static const char *skipAscii(const char *p, const char *end) noexcept {
+        constexpr std::uint64_t kHighBits = 0x8080808080808080ULL;
+        while (end - p >= 8) {
+            std::uint64_t chunk;
+            std::memcpy(&chunk, p, sizeof chunk);
+            if (chunk & kHighBits)
+                break;
+            p += 8;
+        }
+        while (p != end && static_cast<unsigned char>(*p) < 0x80)
+            ++p;
+        return p;
+    }
+
+    // Collects one UTF-8 sequence (possibly across feed() calls) and classifies it.
+    // Returns the position after the bytes consumed.
+    template <typename Sink>
+    const char *feedMultibyte(const char *p, const char *end, Sink &sink) {
+        if (pendingLength_ == 0) {
+            const auto lead = static_cast<unsigned char>(*p);
+            expectedLength_ = lead >= 0xC2 && lead <= 0xDF ? 2
+                            : lead >= 0xE0 && lead <= 0xEF ? 3
+                            : lead >= 0xF0 && lead <= 0xF4 ? 4
+                            : 0;
+            if (expectedLength_ == 0) {
+                separator(sink);   // stray continuation byte or invalid lead
+                return p + 1;
+            }
+            pending_[pendingLength_++] = *p++;
+        }
+        while (pendingLength_ < expectedLength_ && p != end) {
+            if ((static_cast<unsigned char>(*p) & 0xC0) != 0x80) {
+                // Truncated sequence: it separates, and *p starts over.
+                pendingLength_ = 0;
+                separator(sink);
+                return p;
+            }
+            pending_[pendingLength_++] = *p++;
+        }
+        if (pendingLength_ < expectedLength_)
+            return p;   // sequence continues in the next buffer
+
+        const char32_t cp = decode();
+        pendingLength_ = 0;
+        if (cp == unicode::kTypographicApostrophe) {
+            joiner(sink, '\'');
+        } else if (const char32_t lower = cp != 0 ? unicode::foldLetter(cp) : 0; lower != 0) {
+            letter(sink, lower);
+        } else {
+            separator(sink);
+        }
+        return p;
+    }
+
+    // Code point of the complete sequence in pending_, or 0 if it is overlong,
+    // a surrogate or out of range.
+    char32_t decode() const noexcept {
+        const auto b = [this](int i) { return static_cast<char32_t>(static_cast<unsigned char>(pending_[i])); };
+        char32_t cp = 0;
+        char32_t minimum = 0;
+        switch (expectedLength_) {
+            case 2:
+                cp = ((b(0) & 0x1F) << 6) | (b(1) & 0x3F);
+                minimum = 0x80;
+                break;
+            case 3:
+                cp = ((b(0) & 0x0F) << 12) | ((b(1) & 0x3F) << 6) | (b(2) & 0x3F);
+                minimum = 0x800;
+                break;
+            default:
+                cp = ((b(0) & 0x07) << 18) | ((b(1) & 0x3F) << 12) | ((b(2) & 0x3F) << 6) | (b(3) & 0x3F);
+                minimum = 0x10000;
+                break;
+        }
+        if (cp < minimum || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+            return 0;
+        return cp;
+    }
+
+    // The three transitions of the byte state machine, for decoded code points.
+    template <typename Sink>
+    void letter(Sink &sink, char32_t lower) {
+        if (joinerPending_) {
+            joinerPending_ = false;
+            token_.push_back(joiner_);
+            if constexpr (Rules::kJoinerEndsToken)
+                emit(sink);
+        }
+        appendUtf8(lower);
+    }
+
+    template <typename Sink>
+    void joiner(Sink &sink, char c) {
+        if (token_.empty())
+            return;
+        if (joinerPending_) {
+            joinerPending_ = false;
+            emit(sink);
+            return;
+        }
+        joinerPending_ = true;
+        joiner_ = c;
+    }
+
+    template <typename Sink>
+    void separator(Sink &sink) {
+        joinerPending_ = false;
+        if (!token_.empty())
+            emit(sink);
+    }
+
+    void appendUtf8(char32_t cp) {
+        if (cp < 0x80) {
+            token_.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            token_.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            token_.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            token_.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            token_.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            token_.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            token_.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            token_.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            token_.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            token_.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+};
+
+#endif //P3_PART1_TOKENIZER_H
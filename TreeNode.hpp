@@ -6,39 +6,109 @@
 #define P3_PART1_TREENODE_H
 
 #pragma once
+#include <cstdint>
+#include <stdexcept>
 #include <string>
-#include <algorithm>
+#include <string_view>
+#include <vector>
 
+// Node of the BST and of the Huffman tree: 24 bytes, no allocation of its own.
+// Nodes live in a NodeArena and point at each other by 32-bit index; the word
+// is an (offset, length) reference into the arena's character pool. A merged
+// Huffman node refers to the smallest word below it, which is the key the
+// priority queue breaks frequency ties with.
 struct TreeNode {
-    std::string word;
-    int freq = 0;
-    TreeNode* left = nullptr;
-    TreeNode* right = nullptr;
-
-    TreeNode(std::string w, int f = 1): word(std::move(w)), freq(f), left(nullptr), right(nullptr) {};
-
-    std::string keyWord() const {
-        if (left == nullptr && right == nullptr)
-            return word;
-
-        std::string lk;
-        std::string rk;
-
-        if (left != nullptr)
-            lk = left->keyWord();
-        else
-            lk = word;
-
-        if (right != nullptr)
-            rk = right->keyWord();
-        else
-            rk = word;
-
-        if (lk < rk)
-            return lk;
-        else
-            return rk;
+    static constexpr std::uint32_t kNull = 0xFFFFFFFFu;   // no child / no node
+
+    std::uint64_t freq = 0;          // 64-bit: Huffman subtree totals can exceed int
+    std::uint32_t wordOffset = 0;    // into NodeArena's character pool
+    std::uint32_t wordLength = 0;
+    std::uint32_t left = kNull;
+    std::uint32_t right = kNull;
+
+    [[nodiscard]] bool isLeaf() const noexcept { return left == kNull && right == kNull; }
+};
+
+static_assert(sizeof(TreeNode) == 24, "TreeNode is meant to stay at 24 bytes");
+
+// Owns the nodes of one tree and the characters of their words. Indices stay
+// valid as the arena grows (references do not). An arena holds fewer than
+// 2^32 - 1 nodes and 4 GiB of words; add() and addParent() throw
+// std::length_error rather than wrap an index or offset past those limits.
+class NodeArena {
+public:
+    using Index = std::uint32_t;
+
+    void reserve(std::size_t nodes, std::size_t chars) {
+        nodes_.reserve(nodes);
+        chars_.reserve(chars);
+    }
+
+    void clear() noexcept {
+        nodes_.clear();
+        chars_.clear();
+    }
+
+    // A childless node holding a copy of 'word'.
+    Index add(std::string_view word, std::uint64_t freq) {
+        if (word.size() > kMaxChars - chars_.size())
+            throw std::length_error("NodeArena: words exceed 4 GiB");
+        grow(1, word.size());
+        const auto index = static_cast<Index>(nodes_.size());
+        TreeNode &n = nodes_.emplace_back();
+        n.freq = freq;
+        n.wordOffset = static_cast<std::uint32_t>(chars_.size());
+        n.wordLength = static_cast<std::uint32_t>(word.size());
+        chars_.append(word);
+        return index;
+    }
+
+    // Parent of 'a' (left) and 'b' (right) with their summed frequency. It
+    // shares the smaller of their words instead of copying it.
+    Index addParent(Index a, Index b) {
+        const TreeNode &smaller = word(a) < word(b) ? nodes_[a] : nodes_[b];
+        TreeNode parent;
+        parent.freq = nodes_[a].freq + nodes_[b].freq;
+        parent.wordOffset = smaller.wordOffset;
+        parent.wordLength = smaller.wordLength;
+        parent.left = a;
+        parent.right = b;
+        grow(1, 0);
+        const auto index = static_cast<Index>(nodes_.size());
+        nodes_.push_back(parent);
+        return index;
+    }
+
+    [[nodiscard]] TreeNode &operator[](Index i) noexcept { return nodes_[i]; }
+    [[nodiscard]] const TreeNode &operator[](Index i) const noexcept { return nodes_[i]; }
+
+    [[nodiscard]] std::string_view word(Index i) const noexcept {
+        return {chars_.data() + nodes_[i].wordOffset, nodes_[i].wordLength};
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return nodes_.size(); }
+
+    // Heap bytes held, counting reserved capacity.
+    [[nodiscard]] std::size_t bytes() const noexcept {
+        return nodes_.capacity() * sizeof(TreeNode) + chars_.capacity();
+    }
+
+private:
+    static constexpr std::size_t kMaxChars = 0xFFFFFFFFu;   // wordOffset + wordLength fit 32 bits
+
+    std::vector<TreeNode> nodes_;
+    std::string chars_;
+
+    // Grows by half rather than the library's doubling: a tree built one
+    // insert at a time leaves at most a third of its storage unused.
+    void grow(std::size_t nodes, std::size_t chars) {
+        if (nodes_.size() + nodes > TreeNode::kNull)   // kNull itself is never a node
+            throw std::length_error("NodeArena: more than 2^32 - 1 nodes");
+        if (nodes_.size() + nodes > nodes_.capacity())
+            nodes_.reserve(nodes_.size() + nodes_.size() / 2 + nodes + 15);
+        if (chars_.size() + chars > chars_.capacity())
+            chars_.reserve(chars_.size() + chars_.size() / 2 + chars + 63);
     }
 };
 
-#endif //P3_PART1_TREENODE_H
\ No newline at end of file
+#endif //P3_PART1_TREENODE_H
@@ -0,0 +1,158 @@
+#ifndef P3_PART1_UNICODETABLES_H
+#define P3_PART1_UNICODETABLES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+// Compact letter / case-folding tables for the UTF-8 tokenizer mode.
+// Code points are grouped into sorted, non-overlapping ranges; each range says
+// whether its letters are lowercase already, fold by a fixed offset, or come
+// in upper/lower pairs (Latin Extended, Cyrillic, ...). Coverage is the
+// alphabetic scripts we see in practice: Latin, Greek, Cyrillic, Armenian,
+// Georgian, Hebrew, Arabic, Devanagari, Thai, Hangul, Kana and CJK ideographs,
+// plus combining diacritical marks so decomposed accents stay inside words.
+
+namespace unicode {
+
+enum class Fold : std::uint8_t {
+    None,      // letter, no case mapping
+    Offset,    // uppercase; lowercase = cp + delta
+    PairEven,  // even code points are uppercase; lowercase = cp + 1
+    PairOdd,   // odd code points are uppercase; lowercase = cp + 1
+};
+
+struct LetterRange {
+    char32_t first;
+    char32_t last;
+    Fold fold;
+    std::int32_t delta;
+};
+
+inline constexpr LetterRange kLetterRanges[] = {
+    {0x00AA, 0x00AA, Fold::None, 0},
+    {0x00B5, 0x00B5, Fold::None, 0},
+    {0x00BA, 0x00BA, Fold::None, 0},
+    {0x00C0, 0x00D6, Fold::Offset, 32},
+    {0x00D8, 0x00DE, Fold::Offset, 32},
+    {0x00DF, 0x00F6, Fold::None, 0},
+    {0x00F8, 0x00FF, Fold::None, 0},
+    {0x0100, 0x012F, Fold::PairEven, 0},
+    {0x0130, 0x0130, Fold::Offset, 0x0069 - 0x0130},
+    {0x0131, 0x0131, Fold::None, 0},
+    {0x0132, 0x0137, Fold::PairEven, 0},
+    {0x0138, 0x0138, Fold::None, 0},
+    {0x0139, 0x0148, Fold::PairOdd, 0},
+    {0x0149, 0x0149, Fold::None, 0},
+    {0x014A, 0x0177, Fold::PairEven, 0},
+    {0x0178, 0x0178, Fold::Offset, 0x00FF - 0x0178},
+    {0x0179, 0x017E, Fold::PairOdd, 0},
+    {0x017F, 0x01CC, Fold::None, 0},
+    {0x01CD, 0x01DC, Fold::PairOdd, 0},
+    {0x01DD, 0x01DD, Fold::None, 0},
+    {0x01DE, 0x01EF, Fold::PairEven, 0},
+    {0x01F0, 0x01F7, Fold::None, 0},
+    {0x01F8, 0x021F, Fold::PairEven, 0},
+    {0x0220, 0x0221, Fold::None, 0},
+    {0x0222, 0x0233, Fold::PairEven, 0},
+    {0x0234, 0x0245, Fold::None, 0},
+    {0x0246, 0x024F, Fold::PairEven, 0},
+    {0x0250, 0x02AF, Fold::None, 0},
+    {0x0300, 0x036F, Fold::None, 0},          // combining diacritical marks
+    {0x0370, 0x0373, Fold::PairEven, 0},
+    {0x0376, 0x0377, Fold::PairEven, 0},
+    {0x037B, 0x037D, Fold::None, 0},
+    {0x0386, 0x0386, Fold::Offset, 38},
+    {0x0388, 0x038A, Fold::Offset, 37},
+    {0x038C, 0x038C, Fold::Offset, 64},
+    {0x038E, 0x038F, Fold::Offset, 63},
+    {0x0390, 0x0390, Fold::None, 0},
+    {0x0391, 0x03A1, Fold::Offset, 32},
+    {0x03A3, 0x03AB, Fold::Offset, 32},
+    {0x03AC, 0x03D7, Fold::None, 0},
+    {0x03D8, 0x03EF, Fold::PairEven, 0},
+    {0x03F0, 0x03F5, Fold::None, 0},
+    {0x03F7, 0x03F8, Fold::PairOdd, 0},
+    {0x03F9, 0x03FF, Fold::None, 0},
+    {0x0400, 0x040F, Fold::Offset, 80},
+    {0x0410, 0x042F, Fold::Offset, 32},
+    {0x0430, 0x045F, Fold::None, 0},
+    {0x0460, 0x0481, Fold::PairEven, 0},
+    {0x048A, 0x04BF, Fold::PairEven, 0},
+    {0x04C0, 0x04C0, Fold::Offset, 15},
+    {0x04C1, 0x04CE, Fold::PairOdd, 0},
+    {0x04CF, 0x04CF, Fold::None, 0},
+    {0x04D0, 0x052F, Fold::PairEven, 0},
+    {0x0531, 0x0556, Fold::Offset, 48},
+    {0x0561, 0x0587, Fold::None, 0},
+    {0x05D0, 0x05EA, Fold::None, 0},
+    {0x0620, 0x064A, Fold::None, 0},
+    {0x0900, 0x0963, Fold::None, 0},          // Devanagari letters and vowel signs
+    {0x0E01, 0x0E3A, Fold::None, 0},
+    {0x0E40, 0x0E4E, Fold::None, 0},
+    {0x10A0, 0x10C5, Fold::Offset, 0x2D00 - 0x10A0},
+    {0x10D0, 0x10FA, Fold::None, 0},
+    {0x1100, 0x11FF, Fold::None, 0},
+    {0x1E00, 0x1E95, Fold::PairEven, 0},
+    {0x1E96, 0x1E9D, Fold::None, 0},
+    {0x1E9E, 0x1E9E, Fold::Offset, 0x00DF - 0x1E9E},
+    {0x1E9F, 0x1E9F, Fold::None, 0},
+    {0x1EA0, 0x1EFF, Fold::PairEven, 0},
+    {0x1F00, 0x1FBC, Fold::None, 0},
+    {0x2D00, 0x2D25, Fold::None, 0},
+    {0x3041, 0x3096, Fold::None, 0},
+    {0x309D, 0x309F, Fold::None, 0},
+    {0x30A1, 0x30FA, Fold::None, 0},
+    {0x30FC, 0x30FF, Fold::None, 0},
+    {0x3400, 0x4DBF, Fold::None, 0},
+    {0x4E00, 0x9FFF, Fold::None, 0},
+    {0xAC00, 0xD7A3, Fold::None, 0},
+    {0xFF21, 0xFF3A, Fold::Offset, 32},
+    {0xFF41, 0xFF5A, Fold::None, 0},
+};
+
+constexpr bool rangesAreSorted() {
+    for (std::size_t i = 0; i < std::size(kLetterRanges); ++i) {
+        if (kLetterRanges[i].first > kLetterRanges[i].last)
+            return false;
+        if (i > 0 && kLetterRanges[i - 1].last >= kLetterRanges[i].first)
+            return false;
+    }
+    return true;
+}
+static_assert(rangesAreSorted(), "kLetterRanges must be sorted and non-overlapping");
+
+// Right single quotation mark, treated as an apostrophe.
+inline constexpr char32_t kTypographicApostrophe = 0x2019;
+
+// Lowercase form of 'cp' if it is a letter, or 0 if it is not a letter.
+constexpr char32_t foldLetter(char32_t cp) noexcept {
+    const auto *end = std::end(kLetterRanges);
+    const auto *it = std::upper_bound(std::begin(kLetterRanges), end, cp,
+                                      [](char32_t c, const LetterRange &r) { return c < r.first; });
+    if (it == std::begin(kLetterRanges))
+        return 0;
+    const LetterRange &r = *(it - 1);
+    if (cp > r.last)
+        return 0;
+    switch (r.fold) {
+        case Fold::Offset:
+            return static_cast<char32_t>(static_cast<std::int32_t>(cp) + r.delta);
+        case Fold::PairEven:
+            return (cp % 2 == 0) ? cp + 1 : cp;
+        case Fold::PairOdd:
+            return (cp % 2 == 1) ? cp + 1 : cp;
+        case Fold::None:
+        default:
+            return cp;
+    }
+}
+
+static_assert(foldLetter(0x00C9) == 0x00E9);   // É -> é
+static_assert(foldLetter(0x0416) == 0x0436);   // Ж -> ж
+static_assert(foldLetter(0x0100) == 0x0101);   // Ā -> ā
+static_assert(foldLetter(0x2014) == 0);        // em dash is not a letter
+
+} // namespace unicode
+
+#endif //P3_PART1_UNICODETABLES_H
@@ -0,0 +1,159 @@
+#include "CorpusGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+// SplitMix64 step
+// pre: none
+// post: advances state_ and returns the next 64 pseudo-random bits
+std::uint64_t CorpusGenerator::next() noexcept {
+    std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// pre: n > 0
+// post: returns a value in [0, n)
+std::size_t CorpusGenerator::below(std::size_t n) noexcept {
+    return static_cast<std::size_t>(next() % n);
+}
+
+// pre: none
+// post: returns a double in [0, 1) built from the top 53 bits
+double CorpusGenerator::unit() noexcept {
+    return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// pre: 0 < minLen <= maxLen
+// post: returns a lowercase word with length in [minLen, maxLen]
+std::string CorpusGenerator::randomWord(std::size_t minLen, std::size_t maxLen) {
+    const std::size_t len = minLen + below(maxLen - minLen + 1);
+    std::string w;
+    w.reserve(len);
+    for (std::size_t i = 0; i < len; ++i)
+        w.push_back(static_cast<char>('a' + below(26)));
+    return w;
+}
+
+// pre: vocabSize > 0
+// post: returns 'vocabSize' distinct words in generation order
+std::vector<std::string> CorpusGenerator::vocabulary(std::size_t vocabSize) {
+    std::set<std::string> seen;
+    std::vector<std::string> words;
+    words.reserve(vocabSize);
+    while (words.size() < vocabSize) {
+        std::string w = randomWord(2, 12);
+        if (seen.insert(w).second)
+            words.push_back(std::move(w));
+    }
+    return words;
+}
+
+// Zipf-distributed text
+// pre: vocabSize > 0, s > 0
+// post: returns roughly 'bytes' bytes; rank r is drawn with weight 1 / r^s
+std::string CorpusGenerator::zipf(std::size_t bytes, std::size_t vocabSize, double s) {
+    const std::vector<std::string> words = vocabulary(vocabSize);
+
+    std::vector<double> cdf(vocabSize);
+    double total = 0.0;
+    for (std::size_t r = 0; r < vocabSize; ++r) {
+        total += 1.0 / std::pow(static_cast<double>(r + 1), s);
+        cdf[r] = total;
+    }
+
+    static const char *const separators[] = {" ", " ", " ", " ", "\n", ", ", ". ", " - ", "; ", "\t"};
+    std::string out;
+    out.reserve(bytes + 64);
+    while (out.size() < bytes) {
+        const double u = unit() * total;
+        const auto it = std::upper_bound(cdf.begin(), cdf.end(), u);
+        const std::size_t rank = std::min<std::size_t>(it - cdf.begin(), vocabSize - 1);
+        out += words[rank];
+        out += separators[below(std::size(separators))];
+    }
+    return out;
+}
+
+// Sorted adversarial text
+// pre: vocabSize > 0
+// post: returns the sorted vocabulary, one word per line, repeated up to 'bytes'
+std::string CorpusGenerator::sortedAdversarial(std::size_t bytes, std::size_t vocabSize) {
+    std::vector<std::string> words = vocabulary(vocabSize);
+    std::sort(words.begin(), words.end());
+
+    std::string out;
+    out.reserve(bytes + 64);
+    while (out.size() < bytes) {
+        for (const auto &w : words) {
+            out += w;
+            out += '\n';
+            if (out.size() >= bytes)
+                break;
+        }
+    }
+    return out;
+}
+
+// Apostrophe-heavy text
+// pre: none
+// post: returns roughly 'bytes' bytes of words mixed with apostrophe patterns
+std::string CorpusGenerator::apostropheHeavy(std::size_t bytes) {
+    static const char *const forms[] = {"don't", "it's", "o'clock", "rock'n'roll", "'tis", "y'all'",
+                                        "''quoted''", "'", "students'", "can''t", "ma'am"};
+    static const char *const suffixes[] = {"s", "t", "ll", "re", "ve", "d", "s'"};
+    const std::vector<std::string> stems = vocabulary(2000);
+    std::string out;
+    out.reserve(bytes + 64);
+    while (out.size() < bytes) {
+        if (below(3) == 0) {
+            out += forms[below(std::size(forms))];
+        } else {
+            out += stems[below(stems.size())];
+            out += '\'';
+            out += suffixes[below(std::size(suffixes))];
+        }
+        out += below(4) == 0 ? "' " : " ";
+    }
+    return out;
+}
+
+// Non-ASCII noise
+// pre: none
+// post: returns roughly 'bytes' bytes of words, UTF-8 letters and stray high bytes
+std::string CorpusGenerator::nonAsciiNoise(std::size_t bytes) {
+    static const char *const utf8[] = {"\xC3\xA9", "\xC3\xBC", "\xC3\x9F", "\xCE\xB1\xCE\xB2",
+                                       "\xD0\xB4\xD0\xB0", "\xE4\xB8\xAD\xE6\x96\x87", "\xE2\x80\x94"};
+    const std::vector<std::string> words = vocabulary(3000);
+    std::string out;
+    out.reserve(bytes + 64);
+    while (out.size() < bytes) {
+        switch (below(4)) {
+            case 0:
+                out += utf8[below(std::size(utf8))];
+                break;
+            case 1:
+                out.push_back(static_cast<char>(0x80 + below(128)));
+                break;
+            default:
+                out += words[below(words.size())];
+                break;
+        }
+        if (below(2) == 0)
+            out += ' ';
+    }
+    return out;
+}
+
+// pre: none
+// post: returns the 64-bit FNV-1a hash of 'text'
+std::uint64_t CorpusGenerator::checksum(const std::string &text) noexcept {
+    std::uint64_t h = 0xCBF29CE484222325ULL;
+    for (unsigned char c : text) {
+        h ^= c;
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
@@ -0,0 +1,43 @@
+#ifndef P3_PART1_CORPUSGENERATOR_H
+#define P3_PART1_CORPUSGENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Deterministic synthetic text corpora for the benchmarks.
+// Every generator is driven by its own SplitMix64 stream, so a given
+// (kind, size, seed) produces the same bytes on every platform and every
+// commit, which keeps benchmark numbers comparable over time.
+class CorpusGenerator {
+public:
+    explicit CorpusGenerator(std::uint64_t seed) : state_(seed) {}
+
+    // Words drawn from a Zipf(s) distribution over a 'vocabSize' vocabulary,
+    // separated by a mix of whitespace and punctuation.
+    std::string zipf(std::size_t bytes, std::size_t vocabSize, double s);
+
+    // A lexicographically sorted word list repeated in order: every insert
+    // walks the right spine of the BST, so the tree degenerates to a list.
+    std::string sortedAdversarial(std::size_t bytes, std::size_t vocabSize);
+
+    // Contractions, possessives, doubled and dangling apostrophes.
+    std::string apostropheHeavy(std::size_t bytes);
+
+    // ASCII words interleaved with multi-byte UTF-8 and raw high bytes.
+    std::string nonAsciiNoise(std::size_t bytes);
+
+    // FNV-1a digest, printed next to results to show two runs saw the same input.
+    static std::uint64_t checksum(const std::string &text) noexcept;
+
+private:
+    std::uint64_t state_;
+
+    std::uint64_t next() noexcept;
+    std::size_t below(std::size_t n) noexcept;   // uniform in [0, n)
+    double unit() noexcept;                      // uniform in [0, 1)
+    std::string randomWord(std::size_t minLen, std::size_t maxLen);
+    std::vector<std::string> vocabulary(std::size_t vocabSize);
+};
+
+#endif //P3_PART1_CORPUSGENERATOR_H
@@ -0,0 +1,183 @@
+#include "ReferencePipeline.hpp"
+
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace reference {
+
+namespace {
+
+// The original Scanner::readWord, unchanged apart from the name.
+std::string readWord(std::istream &in) {
+    std::string token;
+    int c_int;
+
+    while ((c_int = in.get()) != EOF) {
+        unsigned char ch = static_cast<unsigned char>(c_int);
+        if (std::isalpha(ch) && ch < 128) {
+            token.push_back(static_cast<char>(std::tolower(ch)));
+            break;
+        }
+    }
+
+    if (token.empty()) return {};
+
+    while ((c_int = in.peek()) != EOF) {
+        unsigned char ch = static_cast<unsigned char>(c_int);
+        if (std::isalpha(ch) && ch < 128) {
+            in.get();
+            token.push_back(static_cast<char>(std::tolower(ch)));
+            continue;
+        }
+        if (ch == '\'') {
+            in.get();
+            int next = in.peek();
+            if (next != EOF) {
+                unsigned char nch = static_cast<unsigned char>(next);
+                if (std::isalpha(nch) && nch < 128) {
+                    token.push_back('\'');
+                }
+            }
+            break;
+        }
+        break;
+    }
+    return token;
+}
+
+// Huffman node with its queue key (smallest word below it) stored instead of recomputed.
+struct Node {
+    std::string word;
+    std::string key;
+    int freq = 0;
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+};
+
+// Original queue order: higher frequency first, ties by smaller key.
+bool higherPriority(const Node *a, const Node *b) {
+    if (a->freq != b->freq)
+        return a->freq > b->freq;
+    return a->key < b->key;
+}
+
+// The original PriorityQueue::insert: linear scan, minimum kept at the back.
+void insertSorted(std::vector<Node *> &items, Node *node) {
+    std::size_t position = 0;
+    while (position < items.size() && higherPriority(items[position], node))
+        ++position;
+    items.insert(items.begin() + static_cast<std::ptrdiff_t>(position), node);
+}
+
+void writeHeaderPreorder(const Node *n, std::string &prefix, std::ostream &os,
+                         std::map<std::string, std::string> &codes) {
+    if (!n->left && !n->right) {
+        const std::string code = prefix.empty() ? std::string("0") : prefix;
+        os << n->word << ' ' << code << '\n';
+        codes.emplace(n->word, code);
+        return;
+    }
+    prefix.push_back('0');
+    writeHeaderPreorder(n->left.get(), prefix, os, codes);
+    prefix.pop_back();
+    prefix.push_back('1');
+    writeHeaderPreorder(n->right.get(), prefix, os, codes);
+    prefix.pop_back();
+}
+
+} // namespace
+
+// Runs the original pipeline
+// pre: 'input' names a readable file
+// post: returns all four outputs exactly as the original program wrote them
+//       (an empty input yields empty .hdr and .code)
+PipelineOutputs run(const std::filesystem::path &input) {
+    std::ifstream in(input, std::ios::binary);
+    std::vector<std::string> words;
+    for (std::string w = readWord(in); !w.empty(); w = readWord(in))
+        words.push_back(std::move(w));
+
+    PipelineOutputs out;
+    std::ostringstream tokens;
+    for (const std::string &w : words)
+        tokens << w << '\n';
+    out.tokens = tokens.str();
+
+    std::map<std::string, int> counts;
+    for (const std::string &w : words)
+        ++counts[w];
+
+    // Leaves own themselves until merged; the queue holds raw pointers like the original.
+    std::vector<std::unique_ptr<Node>> leaves;
+    std::vector<Node *> queue;
+    for (const auto &[w, c] : counts) {
+        auto leaf = std::make_unique<Node>();
+        leaf->word = w;
+        leaf->key = w;
+        leaf->freq = c;
+        insertSorted(queue, leaf.get());
+        leaves.push_back(std::move(leaf));
+    }
+
+    std::ostringstream freq;
+    for (const Node *n : queue)
+        freq << std::setw(10) << n->freq << ' ' << n->key << '\n';
+    out.freq = freq.str();
+
+    std::vector<std::unique_ptr<Node>> owned;   // nodes not yet attached to a parent
+    owned.reserve(leaves.size());
+    for (auto &leaf : leaves)
+        owned.push_back(std::move(leaf));
+    const auto take = [&owned](Node *n) {
+        for (auto &p : owned) {
+            if (p.get() == n)
+                return std::move(p);
+        }
+        return std::unique_ptr<Node>();
+    };
+
+    while (queue.size() > 1) {
+        Node *a = queue.back();
+        queue.pop_back();
+        Node *b = queue.back();
+        queue.pop_back();
+        auto parent = std::make_unique<Node>();
+        parent->freq = a->freq + b->freq;
+        parent->key = std::min(a->key, b->key);
+        parent->left = take(a);
+        parent->right = take(b);
+        insertSorted(queue, parent.get());
+        owned.push_back(std::move(parent));
+    }
+
+    std::ostringstream hdr;
+    std::ostringstream code;
+    if (!queue.empty()) {
+        std::map<std::string, std::string> codes;
+        std::string prefix;
+        writeHeaderPreorder(queue.front(), prefix, hdr, codes);
+
+        int col = 0;
+        for (const std::string &w : words) {
+            for (char bit : codes[w]) {
+                code.put(bit);
+                if (++col == 80) {
+                    code.put('\n');
+                    col = 0;
+                }
+            }
+        }
+        if (col != 0)
+            code.put('\n');
+    }
+    out.hdr = hdr.str();
+    out.code = code.str();
+    return out;
+}
+
+} // namespace reference
@@ -0,0 +1,29 @@
+#ifndef P3_PART1_REFERENCEPIPELINE_H
+#define P3_PART1_REFERENCEPIPELINE_H
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+// The four files the program writes for one input, held in memory. A variant
+// that only produces some of them leaves the others empty (std::nullopt) and
+// is compared on the rest.
+struct PipelineOutputs {
+    std::optional<std::string> tokens;
+    std::optional<std::string> freq;
+    std::optional<std::string> hdr;
+    std::optional<std::string> code;
+};
+
+// A frozen, self-contained copy of the project's original pipeline: the
+// character-at-a-time readWord scanner, an ordered map for counting, the
+// sorted-vector priority queue drained for .freq, and the string-code Huffman
+// encoder. It shares no code with the optimized classes, so it stays a fixed
+// point to diff them against. Deliberately slow; meant for small fuzz inputs.
+namespace reference {
+
+PipelineOutputs run(const std::filesystem::path &input);
+
+} // namespace reference
+
+#endif //P3_PART1_REFERENCEPIPELINE_H
@@ -0,0 +1,418 @@
+// Stage and end-to-end throughput benchmarks over deterministic synthetic corpora.
+//
+// Usage: p3_bench [--size MiB] [--reps N] [--corpus name]
+//
+// Every stage is timed best-of-N on the same input and reported as MB/s of
+// source text and Mtok/s of scanned tokens, so numbers from different commits
+// line up row by row. The fnv column identifies the exact corpus bytes.
+//
+// The cold-start corpus (--corpus cold-start) is many small files run through
+// the whole per-file pipeline with real output files, once with the original
+// probe-then-open sequence and once opening every file exactly once; on small
+// inputs it is the file-system round trips that dominate.
+//
+// The mutex-bst/striped/batched rows count the same tokens from 1, 2, 4, ...
+// producer threads (up to the hardware thread count) into one vocabulary.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef P3_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "CorpusGenerator.hpp"
+#include "../Scanner.hpp"
+#include "../BinSearchTree.hpp"
+#include "../ConcurrentCounter.hpp"
+#include "../Ranking.hpp"
+#include "../HuffmanTree.h"
+#include "../TokenDictionary.hpp"
+#include "../utils.hpp"
+
+namespace {
+
+struct Corpus {
+    std::string name;
+    std::string text;
+    std::filesystem::path path;
+};
+
+struct BenchConfig {
+    double sizeMiB = 1.0;
+    int reps = 3;
+    std::string only;   // empty = every corpus
+};
+
+// Runs 'fn' 'reps' times and returns the fastest wall-clock time in seconds.
+double bestOf(int reps, const std::function<void()> &fn) {
+    double best = 0.0;
+    for (int r = 0; r < reps; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (r == 0 || elapsed.count() < best)
+            best = elapsed.count();
+    }
+    return best;
+}
+
+void printRow(const std::string &corpus, const std::string &stage, double seconds,
+              std::size_t bytes, std::size_t tokens) {
+    const double mbps = seconds > 0.0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+    const double mtps = seconds > 0.0 ? static_cast<double>(tokens) / 1e6 / seconds : 0.0;
+    std::cout << std::left << std::setw(18) << corpus << std::setw(12) << stage
+              << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << seconds * 1000.0
+              << std::setw(12) << mbps
+              << std::setw(12) << mtps << '\n';
+}
+
+// Ranks a copy of the counts, the way main.cpp orders the .freq file.
+std::vector<std::pair<std::string, std::uint64_t>> rankStage(std::vector<std::pair<std::string, std::uint64_t>> frequencies) {
+    rankByFrequency(frequencies);
+    return frequencies;
+}
+
+// Runs 'producer(begin, end)' on 'threads' threads, each over its own contiguous slice of 'words'.
+void forEachSlice(const std::vector<std::string> &words, unsigned threads,
+                  const std::function<void(std::size_t, std::size_t)> &producer) {
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        const std::size_t begin = words.size() * t / threads;
+        const std::size_t end = words.size() * (t + 1) / threads;
+        pool.emplace_back(producer, begin, end);
+    }
+    for (std::thread &th : pool)
+        th.join();
+}
+
+// Multi-producer counting at 1, 2, 4, ... threads: the BST behind one mutex
+// (what callers had to do before), the striped counter token by token, and
+// the striped counter behind per-thread batches.
+void runConcurrentCounting(const Corpus &corpus, const BenchConfig &config,
+                           const std::vector<std::string> &words) {
+    const unsigned maxThreads = std::max(4u, std::thread::hardware_concurrency());
+    const std::size_t bytes = corpus.text.size();
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        const std::string suffix = "-" + std::to_string(threads);
+        printRow(corpus.name, "mutex-bst" + suffix, bestOf(config.reps, [&] {
+            BinSearchTree t;
+            std::mutex m;
+            forEachSlice(words, threads, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    std::lock_guard lock(m);
+                    t.insert(words[i]);
+                }
+            });
+        }), bytes, words.size());
+
+        printRow(corpus.name, "striped" + suffix, bestOf(config.reps, [&] {
+            ConcurrentCounter c;
+            forEachSlice(words, threads, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i)
+                    c.insert(words[i]);
+            });
+        }), bytes, words.size());
+
+        printRow(corpus.name, "batched" + suffix, bestOf(config.reps, [&] {
+            ConcurrentCounter c;
+            forEachSlice(words, threads, [&](std::size_t begin, std::size_t end) {
+                ConcurrentCounter::Batch batch(c);
+                for (std::size_t i = begin; i < end; ++i)
+                    batch.insert(words[i]);
+            });
+        }), bytes, words.size());
+    }
+}
+
+void runCorpus(const Corpus &corpus, const BenchConfig &config) {
+    const std::size_t bytes = corpus.text.size();
+
+    std::vector<std::string> words;
+    Scanner(corpus.path).tokenize(words);
+    const std::size_t tokens = words.size();
+
+    BinSearchTree bst;
+    bst.bulkInsert(words);
+    std::vector<std::pair<std::string, std::uint64_t>> frequencies;
+    bst.inorderCollect(frequencies);
+
+    std::cout << "# " << corpus.name << " bytes=" << bytes << " tokens=" << tokens
+              << " unique=" << frequencies.size() << " bst_height=" << bst.height()
+              << " fnv=" << std::hex << CorpusGenerator::checksum(corpus.text) << std::dec << '\n';
+
+    printRow(corpus.name, "scan", bestOf(config.reps, [&] {
+        std::vector<std::string> out;
+        Scanner(corpus.path).tokenize(out);
+    }), bytes, tokens);
+
+    printRow(corpus.name, "scan-utf8", bestOf(config.reps, [&] {
+        std::vector<std::string> out;
+        BasicScanner<Utf8WordRules>(corpus.path).tokenize(out);
+    }), bytes, tokens);
+
+#ifdef P3_HAVE_ZLIB
+    // Same text, gzip-compressed: scanning runs alongside inflate on the reader thread.
+    const std::filesystem::path gzPath = corpus.path.string() + ".gz";
+    if (gzFile gz = gzopen(gzPath.c_str(), "wb6")) {
+        gzwrite(gz, corpus.text.data(), static_cast<unsigned>(corpus.text.size()));
+        gzclose(gz);
+        printRow(corpus.name, "scan-gzip", bestOf(config.reps, [&] {
+            std::vector<std::string> out;
+            Scanner(gzPath).tokenize(out);
+        }), bytes, tokens);
+        std::filesystem::remove(gzPath);
+    }
+#endif
+
+    printRow(corpus.name, "count", bestOf(config.reps, [&] {
+        BinSearchTree t;
+        t.bulkInsert(words);
+        std::vector<std::pair<std::string, std::uint64_t>> out;
+        t.inorderCollect(out);
+    }), bytes, tokens);
+
+    runConcurrentCounting(corpus, config, words);
+
+    printRow(corpus.name, "rank", bestOf(config.reps, [&] {
+        rankStage(frequencies);
+    }), bytes, tokens);
+
+    const std::vector<std::pair<std::string, std::uint64_t>> ranked = rankStage(frequencies);
+    printRow(corpus.name, "huffman", bestOf(config.reps, [&] {
+        HuffmanTree ht = HuffmanTree::buildFromCounts(ranked);
+    }), bytes, tokens);
+
+    const HuffmanTree ht = HuffmanTree::buildFromCounts(ranked);
+    printRow(corpus.name, "encode", bestOf(config.reps, [&] {
+        std::ostringstream hdr, code;
+        ht.writeHeader(hdr);
+        ht.encode(words, code, 80);
+    }), bytes, tokens);
+
+    TokenDictionary dict;
+    std::vector<TokenDictionary::Id> ids;
+    Scanner(corpus.path).tokenize(ids, dict);
+
+    printRow(corpus.name, "scan-ids", bestOf(config.reps, [&] {
+        TokenDictionary d;
+        std::vector<TokenDictionary::Id> out;
+        Scanner(corpus.path).tokenize(out, d);
+    }), bytes, tokens);
+
+    printRow(corpus.name, "count-ids", bestOf(config.reps, [&] {
+        std::vector<std::uint64_t> c = countTokens(ids, dict.size());
+    }), bytes, tokens);
+
+    const std::vector<std::uint64_t> counts = countTokens(ids, dict.size());
+    printRow(corpus.name, "rank-ids", bestOf(config.reps, [&] {
+        std::vector<TokenDictionary::Id> r = rankIds(counts, dict);
+    }), bytes, tokens);
+
+    const std::vector<TokenDictionary::Id> rankedIds = rankIds(counts, dict);
+    printRow(corpus.name, "huffman-ids", bestOf(config.reps, [&] {
+        HuffmanTree h = HuffmanTree::buildFromIds(rankedIds, counts, dict);
+    }), bytes, tokens);
+
+    const HuffmanTree htIds = HuffmanTree::buildFromIds(rankedIds, counts, dict);
+    printRow(corpus.name, "encode-ids", bestOf(config.reps, [&] {
+        std::ostringstream hdr, code;
+        htIds.writeHeader(hdr);
+        htIds.encode(ids, code, 80);
+    }), bytes, tokens);
+
+    // Mirrors main.cpp, with every output file replaced by an in-memory stream.
+    printRow(corpus.name, "end-to-end", bestOf(config.reps, [&] {
+        TokenDictionary d;
+        std::vector<TokenDictionary::Id> in;
+        Scanner(corpus.path).tokenize(in, d);
+        std::ostringstream tok, freq, hdr, code;
+        writeTokens(tok, in, d);
+        const std::vector<std::uint64_t> c = countTokens(in, d.size());
+        BinSearchTree t;
+        for (TokenDictionary::Id id = 0; id < d.size(); ++id)
+            t.insert(d.word(id), c[id]);
+        const std::vector<TokenDictionary::Id> r = rankIds(c, d);
+        writeFrequencies(freq, r, c, d);
+        HuffmanTree h = HuffmanTree::buildFromIds(r, c, d);
+        h.writeHeader(hdr);
+        h.encode(in, code, 80);
+    }), bytes, tokens);
+}
+
+// Writes the four outputs for already-scanned ids through open streams.
+void writeOutputs(const std::vector<TokenDictionary::Id> &ids, const TokenDictionary &dict,
+                  std::ofstream &tokens, std::ofstream &freq, std::ofstream &hdr, std::ofstream &code) {
+    writeTokens(tokens, ids, dict);
+    const std::vector<std::uint64_t> counts = countTokens(ids, dict.size());
+    const std::vector<TokenDictionary::Id> ranked = rankIds(counts, dict);
+    writeFrequencies(freq, ranked, counts, dict);
+    HuffmanTree h = HuffmanTree::buildFromIds(ranked, counts, dict);
+    h.writeHeader(hdr);
+    h.encode(ids, code, 80);
+}
+
+// Per-file latency of the start-up and output path on many small inputs.
+void runColdStart(const std::filesystem::path &dir, const BenchConfig &config) {
+    constexpr int kFiles = 200;
+    const std::filesystem::path inDir = dir / "cold";
+    const std::filesystem::path outDir = inDir / "input_output";
+    std::filesystem::create_directories(outDir);
+
+    std::vector<std::string> inputs;
+    std::size_t bytes = 0;
+    for (int i = 0; i < kFiles; ++i) {
+        const std::string text = CorpusGenerator(100 + i).zipf(2048, 500, 1.1);
+        inputs.push_back((inDir / ("doc" + std::to_string(i) + ".txt")).string());
+        std::ofstream(inputs.back(), std::ios::binary) << text;
+        bytes += text.size();
+    }
+    std::size_t tokens = 0;
+    for (const std::string &in : inputs) {
+        TokenDictionary d;
+        std::vector<TokenDictionary::Id> ids;
+        Scanner(in).tokenize(ids, d);
+        tokens += ids.size();
+    }
+    const auto outName = [&](std::size_t i, const char *ext) {
+        return (outDir / ("doc" + std::to_string(i) + ext)).string();
+    };
+
+    // The checks main.cpp and Scanner used to run before reading an input:
+    // three probe-opens of the input, directory stats, and a truncating test
+    // open of .tokens and .freq that were then opened again for writing.
+    const auto legacyProbes = [&](std::size_t i) {
+        const std::string &in = inputs[i];
+        regularFileExistsAndIsAvailable(in);
+        regularFileExistsAndIsAvailable(in);
+        directoryExists(outDir.string());
+        canOpenForWriting(outName(i, ".tokens"));
+        canOpenForWriting(outName(i, ".freq"));
+        directoryExists(inDir.string());
+        regularFileExistsAndIsAvailable(in);
+    };
+
+    // Start-up path alone: no scanning, every file opened and closed.
+    const double probeOpen = bestOf(config.reps, [&] {
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            legacyProbes(i);
+            Scanner scanner(inputs[i]);
+            scanner.open();
+            std::ofstream tok(outName(i, ".tokens")), freq(outName(i, ".freq")),
+                          hdr(outName(i, ".hdr")), code(outName(i, ".code"));
+        }
+    });
+    printRow("cold-start", "probe-open", probeOpen, bytes, tokens);
+
+    const double singleOpen = bestOf(config.reps, [&] {
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            Scanner scanner(inputs[i]);
+            scanner.open();
+            std::ofstream tok(outName(i, ".tokens")), freq(outName(i, ".freq")),
+                          hdr(outName(i, ".hdr")), code(outName(i, ".code"));
+        }
+    });
+    printRow("cold-start", "single-open", singleOpen, bytes, tokens);
+
+    // Whole per-file pipeline, as main.cpp runs it.
+    const double probeFull = bestOf(config.reps, [&] {
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            legacyProbes(i);
+            TokenDictionary d;
+            std::vector<TokenDictionary::Id> ids;
+            Scanner(inputs[i]).tokenize(ids, d);
+            std::ofstream tok(outName(i, ".tokens")), freq(outName(i, ".freq")),
+                          hdr(outName(i, ".hdr")), code(outName(i, ".code"));
+            writeOutputs(ids, d, tok, freq, hdr, code);
+        }
+    });
+    printRow("cold-start", "probe-full", probeFull, bytes, tokens);
+
+    const double singleFull = bestOf(config.reps, [&] {
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            Scanner scanner(inputs[i]);
+            if (scanner.open() != NO_ERROR)
+                continue;
+            std::ofstream tok(outName(i, ".tokens")), freq(outName(i, ".freq"));
+            TokenDictionary d;
+            std::vector<TokenDictionary::Id> ids;
+            scanner.tokenize(ids, d);
+            std::ofstream hdr(outName(i, ".hdr")), code(outName(i, ".code"));
+            writeOutputs(ids, d, tok, freq, hdr, code);
+        }
+    });
+    printRow("cold-start", "single-full", singleFull, bytes, tokens);
+
+    std::cout << "# cold-start files=" << kFiles << std::fixed << std::setprecision(1)
+              << " us/file open: probes=" << probeOpen * 1e6 / kFiles << " single=" << singleOpen * 1e6 / kFiles
+              << " full: probes=" << probeFull * 1e6 / kFiles << " single=" << singleFull * 1e6 / kFiles << '\n';
+
+    std::filesystem::remove_all(inDir);
+}
+
+bool parseArgs(int argc, char *argv[], BenchConfig &config) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+            return false;
+        if (arg == "--size")
+            config.sizeMiB = std::atof(argv[++i]);
+        else if (arg == "--reps")
+            config.reps = std::atoi(argv[++i]);
+        else if (arg == "--corpus")
+            config.only = argv[++i];
+        else
+            return false;
+    }
+    return config.sizeMiB > 0.0 && config.reps > 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        std::cerr << "Usage: " << argv[0] << " [--size MiB] [--reps N] [--corpus name]\n";
+        return 1;
+    }
+
+    const auto bytes = static_cast<std::size_t>(config.sizeMiB * 1024.0 * 1024.0);
+    std::vector<Corpus> corpora;
+    corpora.push_back({"zipf-1.0", CorpusGenerator(1).zipf(bytes, 20000, 1.0), {}});
+    corpora.push_back({"zipf-1.3", CorpusGenerator(2).zipf(bytes, 5000, 1.3), {}});
+    corpora.push_back({"sorted", CorpusGenerator(3).sortedAdversarial(bytes / 4, 2000), {}});
+    corpora.push_back({"apostrophes", CorpusGenerator(4).apostropheHeavy(bytes), {}});
+    corpora.push_back({"non-ascii", CorpusGenerator(5).nonAsciiNoise(bytes), {}});
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "p3_bench";
+    std::filesystem::create_directories(dir);
+
+    std::cout << "# p3_bench size_mib=" << config.sizeMiB << " reps=" << config.reps << '\n';
+    std::cout << std::left << std::setw(18) << "corpus" << std::setw(12) << "stage"
+              << std::right << std::setw(12) << "ms" << std::setw(12) << "MB/s"
+              << std::setw(12) << "Mtok/s" << '\n';
+
+    for (auto &corpus : corpora) {
+        if (!config.only.empty() && corpus.name != config.only)
+            continue;
+        corpus.path = dir / (corpus.name + ".txt");
+        std::ofstream(corpus.path, std::ios::binary) << corpus.text;
+        runCorpus(corpus, config);
+        std::filesystem::remove(corpus.path);
+    }
+    if (config.only.empty() || config.only == "cold-start")
+        runColdStart(dir, config);
+    return 0;
+}
@@ -0,0 +1,460 @@
+// Differential fuzz and performance harness.
+//
+// Usage: p3_diff [--cases N] [--seed S] [--max-bytes B] [--keep-failures DIR]
+//
+// Every case is an input file (synthetic corpora, byte-level fuzz, mutated
+// corpora and fixed edge cases) run once through the frozen reference
+// pipeline (ReferencePipeline.cpp) and once through each optimized variant.
+// The .tokens, .freq, .hdr and .code bytes a variant produces must equal the
+// reference's exactly; the first mismatch per variant is reported with its
+// offset and, with --keep-failures, the input is saved for replay. Time per
+// variant is summed over all cases and reported as a speedup over the
+// reference. A last check builds a codebook from 70 Fibonacci counts, which
+// must be rejected as needing codes over 64 bits. Exits 1 if any variant
+// disagreed or that check failed.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef P3_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "CorpusGenerator.hpp"
+#include "ReferencePipeline.hpp"
+#include "../AdaptiveHuffman.hpp"
+#include "../BinSearchTree.hpp"
+#include "../CodecServer.hpp"
+#include "../ConcurrentCounter.hpp"
+#include "../HuffmanTree.h"
+#include "../Ranking.hpp"
+#include "../Scanner.hpp"
+#include "../TokenDictionary.hpp"
+
+namespace {
+
+struct DiffConfig {
+    int cases = 200;
+    std::uint64_t seed = 1;
+    std::size_t maxBytes = 64 * 1024;
+    std::filesystem::path keepDir;   // empty = do not keep failing inputs
+};
+
+struct Case {
+    std::string name;
+    std::string text;
+};
+
+// One optimized path. 'asciiOnly' variants are skipped on inputs with bytes >= 0x80,
+// where their tokenizer rules legitimately differ from the reference.
+struct Variant {
+    std::string name;
+    bool asciiOnly = false;
+    std::function<PipelineOutputs(const std::filesystem::path &, const std::string &text,
+                                  const PipelineOutputs &reference)> run;
+    double seconds = 0.0;
+    double referenceSeconds = 0.0;   // reference time on the cases this variant ran
+    int cases = 0;
+    int failures = 0;
+};
+
+std::string toString(const std::function<void(std::ostream &)> &write) {
+    std::ostringstream os;
+    write(os);
+    return os.str();
+}
+
+// The word-vector path: Scanner, BST counting, rankByFrequency, buildFromCounts.
+PipelineOutputs runWords(const std::filesystem::path &path, const std::string &, const PipelineOutputs &) {
+    PipelineOutputs out;
+    std::vector<std::string> words;
+    Scanner(path).tokenize(words);
+    out.tokens = toString([&](std::ostream &os) {
+        for (const std::string &w : words)
+            os << w << '\n';
+    });
+
+    BinSearchTree bst;
+    bst.bulkInsert(words);
+    std::vector<std::pair<std::string, std::uint64_t>> frequencies;
+    bst.inorderCollect(frequencies);
+    rankByFrequency(frequencies);
+    out.freq = toString([&](std::ostream &os) { writeFrequencies(os, frequencies); });
+
+    if (frequencies.empty()) {
+        out.hdr = out.code = std::string();
+        return out;
+    }
+    const HuffmanTree ht = HuffmanTree::buildFromCounts(frequencies);
+    out.hdr = toString([&](std::ostream &os) { ht.writeHeader(os); });
+    out.code = toString([&](std::ostream &os) { ht.encode(words, os, 80); });
+    return out;
+}
+
+// Multi-producer counting: four threads count interleaved tokens into the
+// striped counter (two through batches), and the snapshot replaces the BST's
+// inorderCollect in the word-vector path.
+PipelineOutputs runConcurrent(const std::filesystem::path &path, const std::string &, const PipelineOutputs &) {
+    PipelineOutputs out;
+    std::vector<std::string> words;
+    Scanner(path).tokenize(words);
+
+    constexpr unsigned kThreads = 4;
+    ConcurrentCounter counter(4);
+    {
+        std::vector<std::jthread> producers;
+        for (unsigned t = 0; t < kThreads; ++t) {
+            producers.emplace_back([&words, &counter, t] {
+                if (t % 2 == 0) {
+                    for (std::size_t i = t; i < words.size(); i += kThreads)
+                        counter.insert(words[i]);
+                    return;
+                }
+                ConcurrentCounter::Batch batch(counter, 64);
+                for (std::size_t i = t; i < words.size(); i += kThreads)
+                    batch.insert(words[i]);
+            });
+        }
+    }
+    std::vector<std::pair<std::string, std::uint64_t>> frequencies;
+    counter.snapshot(frequencies);
+    rankByFrequency(frequencies);
+    out.freq = toString([&](std::ostream &os) { writeFrequencies(os, frequencies); });
+
+    if (frequencies.empty()) {
+        out.hdr = out.code = std::string();
+        return out;
+    }
+    const HuffmanTree ht = HuffmanTree::buildFromCounts(frequencies);
+    out.hdr = toString([&](std::ostream &os) { ht.writeHeader(os); });
+    out.code = toString([&](std::ostream &os) { ht.encode(words, os, 80); });
+    return out;
+}
+
+// The interned-id path main.cpp runs, with the rule set as a parameter.
+template <typename Rules>
+PipelineOutputs runIds(const std::filesystem::path &path, const std::string &, const PipelineOutputs &) {
+    PipelineOutputs out;
+    TokenDictionary dict;
+    std::vector<TokenDictionary::Id> ids;
+    BasicScanner<Rules>(path).tokenize(ids, dict);
+    out.tokens = toString([&](std::ostream &os) { writeTokens(os, ids, dict); });
+
+    const std::vector<std::uint64_t> counts = countTokens(ids, dict.size());
+    const std::vector<TokenDictionary::Id> ranked = rankIds(counts, dict);
+    out.freq = toString([&](std::ostream &os) { writeFrequencies(os, ranked, counts, dict); });
+
+    if (ranked.empty()) {
+        out.hdr = out.code = std::string();
+        return out;
+    }
+    const HuffmanTree ht = HuffmanTree::buildFromIds(ranked, counts, dict);
+    out.hdr = toString([&](std::ostream &os) { ht.writeHeader(os); });
+    out.code = toString([&](std::ostream &os) { ht.encode(ids, os, 80); });
+    return out;
+}
+
+#ifdef P3_HAVE_ZLIB
+// The id path over a gzip copy of the input, decoded on the reader thread.
+PipelineOutputs runGzip(const std::filesystem::path &path, const std::string &text, const PipelineOutputs &ref) {
+    const std::filesystem::path gzPath = path.string() + ".gz";
+    if (gzFile gz = gzopen(gzPath.c_str(), "wb6")) {
+        gzwrite(gz, text.data(), static_cast<unsigned>(text.size()));
+        gzclose(gz);
+    }
+    PipelineOutputs out = runIds<AsciiWordRules>(gzPath, text, ref);
+    std::filesystem::remove(gzPath);
+    return out;
+}
+#endif
+
+// The resident-codebook server: the reference header is loaded and the text is
+// encoded, then the code decoded, through in-process requests. Compared on
+// .code and .tokens only; the header it serves is the reference's own.
+PipelineOutputs runServer(const std::filesystem::path &path, const std::string &text, const PipelineOutputs &ref) {
+    PipelineOutputs out;
+    if (ref.hdr->empty())
+        return out;
+    const std::filesystem::path hdrPath = path.string() + ".hdr";
+    std::ofstream(hdrPath) << *ref.hdr;
+
+    CodecServer server("ascii", 1);
+    if (server.load(hdrPath) == NO_ERROR) {
+        const auto body = [](const std::string &response) {
+            const std::size_t nl = response.find('\n');
+            return response.starts_with("OK ") && nl != std::string::npos ? response.substr(nl + 1) : response;
+        };
+        out.code = body(server.handle("ENCODE", text));
+        out.tokens = body(server.handle("DECODE", *out.code));
+    }
+    std::filesystem::remove(hdrPath);
+    return out;
+}
+
+// Single-pass adaptive coding: encoded and decoded again, compared on .tokens.
+PipelineOutputs runAdaptive(const std::filesystem::path &path, const std::string &, const PipelineOutputs &) {
+    std::stringstream code;
+    AdaptiveHuffmanEncoder encoder(code, 80);
+    Scanner(path).tokenize([&encoder](std::string &w) { encoder.encode(w); });
+    encoder.finish();
+
+    PipelineOutputs out;
+    AdaptiveHuffmanDecoder decoder(code);
+    out.tokens = toString([&](std::ostream &os) {
+        std::string word;
+        while (decoder.next(word))
+            os << word << '\n';
+    });
+    return out;
+}
+
+// Byte-level fuzz: letters of both cases, apostrophes in every position,
+// punctuation, whitespace (including CR and NUL) and high bytes.
+std::string fuzzBytes(std::mt19937_64 &rng, std::size_t size) {
+    static constexpr char kSpecial[] = {'\'', '\'', ' ', ' ', '\n', '\r', '\t', '\0', '-', '.', ',', '!', '"', '0', '9', '_'};
+    std::string text;
+    text.reserve(size);
+    while (text.size() < size) {
+        const unsigned roll = static_cast<unsigned>(rng() % 100);
+        if (roll < 60)
+            text.push_back(static_cast<char>((roll & 1 ? 'a' : 'A') + static_cast<int>(rng() % 6)));   // few letters, many repeats
+        else if (roll < 92)
+            text.push_back(kSpecial[rng() % sizeof kSpecial]);
+        else
+            text.push_back(static_cast<char>(0x80 + rng() % 0x80));
+    }
+    return text;
+}
+
+// Overwrites, inserts and deletes a few bytes at random positions.
+std::string mutate(std::mt19937_64 &rng, std::string text) {
+    static constexpr char kBytes[] = {'\'', ' ', 'a', 'Z', '\n', '\0', '\xc3', '\xa9', '\xff'};
+    const int edits = 1 + static_cast<int>(rng() % 16);
+    for (int i = 0; i < edits && !text.empty(); ++i) {
+        const std::size_t pos = rng() % text.size();
+        const char byte = kBytes[rng() % sizeof kBytes];
+        switch (rng() % 3) {
+            case 0: text[pos] = byte; break;
+            case 1: text.insert(text.begin() + static_cast<std::ptrdiff_t>(pos), byte); break;
+            default: text.erase(pos, 1); break;
+        }
+    }
+    return text;
+}
+
+// Inputs that have broken a tokenizer or coder before, or easily could.
+std::vector<Case> edgeCases() {
+    std::vector<Case> cases = {
+        {"empty", ""},
+        {"one-word", "word"},
+        {"one-word-repeated", "same same SAME same\n"},
+        {"two-words", "a b"},
+        {"separators-only", " \t\r\n.,;'''\"--\n"},
+        {"trailing-apostrophe", "dogs' tail'"},
+        {"leading-apostrophe", "'tis 'twas ''a"},
+        {"contractions", "don't can't won't o'clock rock'n'roll"},
+        {"no-final-newline", "alpha beta gamma alpha"},
+        {"crlf", "one\r\ntwo\r\none\r\n"},
+        {"nul-bytes", std::string("ab\0cd\0ab", 8)},
+        {"high-bytes", "caf\xc3\xa9 na\xc3\xafve \xff\xfe word word"},
+        {"long-word", std::string(5000, 'q') + " q " + std::string(5000, 'q')},
+        {"equal-frequencies", "d c b a e f g h"},
+    };
+    // Fibonacci counts give the deepest tree for a token total: 22 words, codes up to 21 bits.
+    std::string fibonacci;
+    for (std::uint64_t i = 0, a = 1, b = 1; i < 22; ++i, b = a + b, a = b - a) {
+        const std::string word = std::string("fib") + static_cast<char>('a' + i) + ' ';
+        for (std::uint64_t n = 0; n < a; ++n)
+            fibonacci += word;
+    }
+    cases.push_back({"fibonacci-counts", fibonacci});
+    // Crosses the scanner's block boundary with a word split across it.
+    std::string big;
+    while (big.size() < 300 * 1024)
+        big += "blockedge straddle word'y ";
+    cases.push_back({"multi-block", big});
+    return cases;
+}
+
+// Counts no text file here can reach: 70 Fibonacci-weighted words need codes
+// of up to 69 bits, which the packed codebook must refuse rather than truncate.
+// pre: none
+// post: returns true if buildFromCounts threw std::length_error
+bool rejectsOverlongCodes() {
+    std::vector<std::pair<std::string, std::uint64_t>> counts;
+    for (std::uint64_t i = 0, a = 1, b = 1; i < 70; ++i, b = a + b, a = b - a)
+        counts.emplace_back("w" + std::to_string(i), a);
+    rankByFrequency(counts);
+    try {
+        (void)HuffmanTree::buildFromCounts(counts);
+    } catch (const std::length_error &) {
+        return true;
+    }
+    return false;
+}
+
+std::vector<Case> generateCases(const DiffConfig &config) {
+    std::vector<Case> cases = edgeCases();
+    std::mt19937_64 rng(config.seed);
+    for (int i = 0; static_cast<int>(cases.size()) < config.cases; ++i) {
+        const std::size_t size = 1 + rng() % config.maxBytes;
+        CorpusGenerator gen(config.seed * 1000003u + static_cast<std::uint64_t>(i));
+        const std::string id = std::to_string(i);
+        switch (i % 6) {
+            case 0: cases.push_back({"zipf-" + id, gen.zipf(size, 1 + rng() % 2000, 0.8 + static_cast<double>(rng() % 8) / 10.0)}); break;
+            case 1: cases.push_back({"fuzz-" + id, fuzzBytes(rng, size)}); break;
+            case 2: cases.push_back({"apostrophes-" + id, gen.apostropheHeavy(size)}); break;
+            case 3: cases.push_back({"non-ascii-" + id, gen.nonAsciiNoise(size)}); break;
+            case 4: cases.push_back({"sorted-" + id, gen.sortedAdversarial(size, 1 + rng() % 500)}); break;
+            default: cases.push_back({"mutated-" + id, mutate(rng, gen.zipf(size, 1 + rng() % 300, 1.1))}); break;
+        }
+    }
+    cases.resize(std::min(cases.size(), static_cast<std::size_t>(std::max(config.cases, 0))));
+    return cases;
+}
+
+// pre: none
+// post: returns an empty string if 'got' matches 'want', else a description of the first difference
+std::string compare(const char *file, const std::string &want, const std::string &got) {
+    const auto mismatch = std::mismatch(want.begin(), want.end(), got.begin(), got.end());
+    if (mismatch.first == want.end() && mismatch.second == got.end())
+        return {};
+    std::ostringstream os;
+    os << file << " differs at byte " << (mismatch.first - want.begin())
+       << " (reference " << want.size() << " bytes, variant " << got.size() << " bytes)";
+    return os.str();
+}
+
+std::string compare(const PipelineOutputs &want, const PipelineOutputs &got) {
+    const std::pair<const char *, const std::optional<std::string> PipelineOutputs::*> files[] = {
+        {".tokens", &PipelineOutputs::tokens}, {".freq", &PipelineOutputs::freq},
+        {".hdr", &PipelineOutputs::hdr}, {".code", &PipelineOutputs::code}};
+    for (const auto &[name, member] : files) {
+        if (!(got.*member))
+            continue;
+        if (std::string diff = compare(name, *(want.*member), *(got.*member)); !diff.empty())
+            return diff;
+    }
+    return {};
+}
+
+bool isAscii(const std::string &text) {
+    return std::all_of(text.begin(), text.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; });
+}
+
+bool parseArgs(int argc, char *argv[], DiffConfig &config) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+            return false;
+        if (arg == "--cases")
+            config.cases = std::atoi(argv[++i]);
+        else if (arg == "--seed")
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--max-bytes")
+            config.maxBytes = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--keep-failures")
+            config.keepDir = argv[++i];
+        else
+            return false;
+    }
+    return config.cases > 0 && config.maxBytes > 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    DiffConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        std::cerr << "Usage: " << argv[0] << " [--cases N] [--seed S] [--max-bytes B] [--keep-failures DIR]\n";
+        return 1;
+    }
+
+    std::vector<Variant> variants;
+    variants.push_back({"words", false, &runWords});
+    variants.push_back({"ids", false, &runIds<AsciiWordRules>});
+    variants.push_back({"ids-utf8", true, &runIds<Utf8WordRules>});
+#ifdef P3_HAVE_ZLIB
+    variants.push_back({"ids-gzip", false, &runGzip});
+#endif
+    variants.push_back({"concurrent", false, &runConcurrent});
+    variants.push_back({"server", false, &runServer});
+    variants.push_back({"adaptive", false, &runAdaptive});
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "p3_diff";
+    std::filesystem::create_directories(dir);
+    const std::filesystem::path input = dir / "case.txt";
+
+    const std::vector<Case> cases = generateCases(config);
+    double referenceSeconds = 0.0;
+    std::size_t totalBytes = 0;
+    int failedCases = 0;
+
+    for (const Case &c : cases) {
+        std::ofstream(input, std::ios::binary | std::ios::trunc) << c.text;
+        totalBytes += c.text.size();
+
+        const auto start = std::chrono::steady_clock::now();
+        const PipelineOutputs want = reference::run(input);
+        const double caseSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        referenceSeconds += caseSeconds;
+
+        bool failed = false;
+        for (Variant &v : variants) {
+            if (v.asciiOnly && !isAscii(c.text))
+                continue;
+            const auto began = std::chrono::steady_clock::now();
+            const PipelineOutputs got = v.run(input, c.text, want);
+            v.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - began).count();
+            v.referenceSeconds += caseSeconds;
+            ++v.cases;
+
+            const std::string diff = compare(want, got);
+            if (diff.empty())
+                continue;
+            if (v.failures++ == 0)
+                std::cout << "MISMATCH " << v.name << " on " << c.name << ": " << diff << '\n';
+            failed = true;
+        }
+        if (failed) {
+            ++failedCases;
+            if (!config.keepDir.empty()) {
+                std::filesystem::create_directories(config.keepDir);
+                std::ofstream(config.keepDir / (c.name + ".txt"), std::ios::binary) << c.text;
+            }
+        }
+    }
+    std::filesystem::remove_all(dir);
+
+    const bool limitHeld = rejectsOverlongCodes();
+    if (!limitHeld)
+        std::cout << "MISMATCH codebook on fibonacci-70: codes over 64 bits were not rejected\n";
+
+    std::cout << "# p3_diff cases=" << cases.size() << " seed=" << config.seed
+              << " bytes=" << totalBytes << " failed=" << failedCases << '\n';
+    std::cout << std::left << std::setw(12) << "variant" << std::right << std::setw(8) << "cases"
+              << std::setw(10) << "failures" << std::setw(12) << "ms" << std::setw(10) << "speedup" << '\n';
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::left << std::setw(12) << "reference" << std::right << std::setw(8) << cases.size()
+              << std::setw(10) << 0 << std::setw(12) << referenceSeconds * 1000.0 << std::setw(10) << 1.0 << '\n';
+    for (const Variant &v : variants) {
+        const double speedup = v.seconds > 0.0 ? v.referenceSeconds / v.seconds : 0.0;
+        std::cout << std::left << std::setw(12) << v.name << std::right << std::setw(8) << v.cases
+                  << std::setw(10) << v.failures << std::setw(12) << v.seconds * 1000.0
+                  << std::setw(10) << speedup << '\n';
+    }
+    return failedCases == 0 && limitHeld ? 0 : 1;
+}
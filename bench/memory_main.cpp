@@ -0,0 +1,262 @@
+// Memory footprint of the BST and the Huffman tree, before and after the
+// compact node layout.
+//
+// Usage: p3_memory [--size MiB]
+//
+// "legacy" is a replica of the original layout: one heap-allocated node per
+// word holding a std::string (plus a second allocation for words longer than
+// the library's inline buffer), an int count and two child pointers, and for
+// the Huffman tree a codebook of node pointers. "compact" is the project's
+// BinSearchTree and HuffmanTree. Both are measured by counting the bytes and
+// allocations that pass through operator new while the structure is built and
+// still alive, so vector slack is included. With glibc the count is the size
+// of the chunk malloc actually handed out, header and rounding included;
+// elsewhere it is the requested size, which understates the legacy numbers.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <queue>
+#include <string>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "CorpusGenerator.hpp"
+#include "../BinSearchTree.hpp"
+#include "../HuffmanTree.h"
+#include "../Ranking.hpp"
+#include "../Tokenizer.hpp"
+
+namespace {
+
+std::size_t liveBytes = 0;     // single-threaded program: plain counters
+std::size_t allocations = 0;
+
+#ifdef __GLIBC__
+// The chunk malloc really hands out: usable size plus its size header.
+std::size_t footprint(void *block) noexcept {
+    return malloc_usable_size(block) + sizeof(std::size_t);
+}
+
+void *countedAlloc(std::size_t size) {
+    void *block = std::malloc(size == 0 ? 1 : size);
+    if (!block)
+        throw std::bad_alloc();
+    liveBytes += footprint(block);
+    ++allocations;
+    return block;
+}
+
+void countedFree(void *p) noexcept {
+    if (!p)
+        return;
+    liveBytes -= footprint(p);
+    std::free(p);
+}
+#else
+// Each block carries its requested size in front so delete can subtract it.
+constexpr std::size_t kHeader = alignof(std::max_align_t);
+
+void *countedAlloc(std::size_t size) {
+    void *block = std::malloc(size + kHeader);
+    if (!block)
+        throw std::bad_alloc();
+    *static_cast<std::size_t *>(block) = size;
+    liveBytes += size;
+    ++allocations;
+    return static_cast<char *>(block) + kHeader;
+}
+
+void countedFree(void *p) noexcept {
+    if (!p)
+        return;
+    void *block = static_cast<char *>(p) - kHeader;
+    liveBytes -= *static_cast<std::size_t *>(block);
+    std::free(block);
+}
+#endif
+
+} // namespace
+
+void *operator new(std::size_t size) { return countedAlloc(size); }
+void *operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void *p) noexcept { countedFree(p); }
+void operator delete[](void *p) noexcept { countedFree(p); }
+void operator delete(void *p, std::size_t) noexcept { countedFree(p); }
+void operator delete[](void *p, std::size_t) noexcept { countedFree(p); }
+
+namespace {
+
+// The node as it was: 56 bytes plus the word's own buffer when it does not fit inline.
+struct LegacyNode {
+    std::string word;
+    int freq = 0;
+    std::uint32_t id = 0xFFFFFFFFu;
+    LegacyNode *left = nullptr;
+    LegacyNode *right = nullptr;
+
+    LegacyNode(std::string w, int f) : word(std::move(w)), freq(f) {}
+};
+
+void destroy(LegacyNode *n) {
+    if (!n)
+        return;
+    destroy(n->left);
+    destroy(n->right);
+    delete n;
+}
+
+LegacyNode *legacyInsert(LegacyNode *node, const std::string &word) {
+    if (!node)
+        return new LegacyNode(word, 1);
+    if (word == node->word)
+        ++node->freq;
+    else if (word < node->word)
+        node->left = legacyInsert(node->left, word);
+    else
+        node->right = legacyInsert(node->right, word);
+    return node;
+}
+
+// Same node count and allocation pattern as the original Huffman build; the
+// merge order does not change the footprint, so a heap stands in for the sorted queue.
+struct LegacyHuffman {
+    LegacyNode *root = nullptr;
+    std::vector<const LegacyNode *> leaves;   // the codebook as it was: pointers and packed codes
+    std::vector<HuffmanTree::Code> codes;
+
+    explicit LegacyHuffman(const std::vector<std::pair<std::string, std::uint64_t>> &counts) {
+        const auto later = [](const LegacyNode *a, const LegacyNode *b) { return a->freq > b->freq; };
+        std::priority_queue<LegacyNode *, std::vector<LegacyNode *>, decltype(later)> pq(later);
+        for (const auto &[w, c] : counts)
+            pq.push(new LegacyNode(w, static_cast<int>(c)));   // the legacy node stored an int
+        while (pq.size() > 1) {
+            LegacyNode *a = pq.top();
+            pq.pop();
+            LegacyNode *b = pq.top();
+            pq.pop();
+            auto *parent = new LegacyNode(std::string{}, a->freq + b->freq);
+            parent->left = a;
+            parent->right = b;
+            pq.push(parent);
+        }
+        root = pq.empty() ? nullptr : pq.top();
+        collect(root, 0, 0);
+    }
+    ~LegacyHuffman() { destroy(root); }
+
+    void collect(const LegacyNode *n, std::uint64_t bits, std::uint32_t length) {
+        if (!n)
+            return;
+        if (!n->left && !n->right) {
+            leaves.push_back(n);
+            codes.push_back({bits, length});
+            return;
+        }
+        collect(n->left, bits << 1, length + 1);
+        collect(n->right, (bits << 1) | 1u, length + 1);
+    }
+};
+
+struct Footprint {
+    std::size_t bytes = 0;
+    std::size_t allocations = 0;
+};
+
+// Builds a structure with 'build', measures what it holds, then lets it go.
+template <typename Build>
+Footprint measure(Build &&build) {
+    const std::size_t bytesBefore = liveBytes;
+    const std::size_t allocationsBefore = allocations;
+    auto structure = build();
+    Footprint f{liveBytes - bytesBefore, allocations - allocationsBefore};
+    (void)structure;
+    return f;
+}
+
+std::vector<std::string> tokenize(const std::string &text) {
+    std::vector<std::string> words;
+    Tokenizer<AsciiWordRules> tokenizer;
+    auto sink = [&words](std::string &w) { words.push_back(std::move(w)); };
+    tokenizer.feed(text.data(), text.data() + text.size(), sink);
+    tokenizer.finish(sink);
+    return words;
+}
+
+void printRow(const std::string &corpus, const std::string &structure, std::size_t nodes,
+              const Footprint &legacy, const Footprint &compact) {
+    const auto kib = [](std::size_t bytes) { return static_cast<double>(bytes) / 1024.0; };
+    const auto perNode = [nodes](std::size_t bytes) { return nodes ? static_cast<double>(bytes) / static_cast<double>(nodes) : 0.0; };
+    std::cout << std::left << std::setw(14) << corpus << std::setw(10) << structure
+              << std::right << std::setw(9) << nodes << std::fixed << std::setprecision(1)
+              << std::setw(12) << kib(legacy.bytes) << std::setw(9) << legacy.allocations
+              << std::setw(8) << perNode(legacy.bytes)
+              << std::setw(12) << kib(compact.bytes) << std::setw(9) << compact.allocations
+              << std::setw(8) << perNode(compact.bytes)
+              << std::setw(8) << std::setprecision(2)
+              << (compact.bytes ? static_cast<double>(legacy.bytes) / static_cast<double>(compact.bytes) : 0.0) << '\n';
+}
+
+void runCorpus(const std::string &name, const std::string &text) {
+    const std::vector<std::string> words = tokenize(text);
+
+    const Footprint legacyBst = measure([&] {
+        LegacyNode *root = nullptr;
+        for (const std::string &w : words)
+            root = legacyInsert(root, w);
+        return std::unique_ptr<LegacyNode, void (*)(LegacyNode *)>(root, &destroy);
+    });
+    const Footprint compactBst = measure([&] {
+        auto bst = std::make_unique<BinSearchTree>();
+        bst->bulkInsert(words);
+        return bst;
+    });
+
+    BinSearchTree bst;
+    bst.bulkInsert(words);
+    std::vector<std::pair<std::string, std::uint64_t>> counts;
+    bst.inorderCollect(counts);
+    rankByFrequency(counts);
+    printRow(name, "bst", counts.size(), legacyBst, compactBst);
+
+    const Footprint legacyHuffman = measure([&] { return std::make_unique<LegacyHuffman>(counts); });
+    const Footprint compactHuffman = measure([&] {
+        return std::make_unique<HuffmanTree>(HuffmanTree::buildFromCounts(counts));
+    });
+    printRow(name, "huffman", counts.empty() ? 0 : 2 * counts.size() - 1, legacyHuffman, compactHuffman);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    double sizeMiB = 4.0;
+    if (argc == 3 && std::string(argv[1]) == "--size")
+        sizeMiB = std::atof(argv[2]);
+    if ((argc != 1 && argc != 3) || sizeMiB <= 0.0) {
+        std::cerr << "Usage: " << argv[0] << " [--size MiB]\n";
+        return 1;
+    }
+    const auto bytes = static_cast<std::size_t>(sizeMiB * 1024.0 * 1024.0);
+
+    std::cout << "# p3_memory size_mib=" << sizeMiB << " sizeof(legacy node)=" << sizeof(LegacyNode)
+              << " sizeof(TreeNode)=" << sizeof(TreeNode) << '\n';
+    std::cout << std::left << std::setw(14) << "corpus" << std::setw(10) << "structure"
+              << std::right << std::setw(9) << "nodes"
+              << std::setw(12) << "legacy_KiB" << std::setw(9) << "allocs" << std::setw(8) << "B/node"
+              << std::setw(12) << "compact_KiB" << std::setw(9) << "allocs" << std::setw(8) << "B/node"
+              << std::setw(8) << "ratio" << '\n';
+
+    runCorpus("zipf-1.0", CorpusGenerator(1).zipf(bytes, 20000, 1.0));
+    runCorpus("zipf-large", CorpusGenerator(6).zipf(bytes, 200000, 0.9));
+    runCorpus("sorted", CorpusGenerator(3).sortedAdversarial(bytes / 4, 2000));
+    runCorpus("non-ascii", CorpusGenerator(5).nonAsciiNoise(bytes));
+    return 0;
+}
@@ -1,37 +1,235 @@
+#include <cstdlib>
+#include <iomanip>
 #include <iostream>
 #include <fstream>
 #include <filesystem>
 #include <string>
 #include <vector>
-#include <iomanip>
 
 #include "Scanner.hpp"
 #include "utils.hpp"
-#include "TreeNode.hpp"
 #include "BinSearchTree.hpp"
-#include "PriorityQueue.hpp"
+#include "Ranking.hpp"
 #include "HuffmanTree.h"
+#include "SpaceSaving.hpp"
+#include "TokenDictionary.hpp"
+#include "PhraseModel.hpp"
+#include "AdaptiveHuffman.hpp"
+#include "CodecServer.hpp"
 
-int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <filename>\n";
-        return 1;
+namespace {
+
+struct Options {
+    std::string fileName;
+    std::size_t topK = 0;            // --top K: print the K heaviest words instead of writing outputs
+    std::size_t approxCapacity = 0;  // --approx N: count in fixed memory with N space-saving slots
+    std::string rules = "ascii";     // --rules NAME: tokenizer rule set (see TokenRules.hpp)
+    std::size_t bigrams = 0;         // --bigrams N: promote up to N word pairs to Huffman symbols
+    bool adaptive = false;           // --adaptive: single-pass adaptive Huffman code, no stored tokens
+    bool adaptiveDecode = false;     // --adaptive-decode: turn an adaptive code back into tokens
+    std::string serveHeader;         // --serve HDR: answer encode/decode requests with this codebook
+    std::string socketPath;          // --socket PATH: serve on a Unix socket instead of stdin/stdout
+    std::size_t threads = 0;         // --threads N: server worker threads (0 = hardware threads)
+};
+
+// Parses "[--rules NAME] [--bigrams N] [--top K [--approx N]] [--adaptive | --adaptive-decode] <filename>"
+// or "[--rules NAME] --serve HDR [--socket PATH] [--threads N]"
+// pre: argv holds argc entries
+// post: returns true and fills 'opts' if the arguments are well formed
+bool parseArgs(int argc, char *argv[], Options &opts) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if ((arg == "--top" || arg == "--approx" || arg == "--bigrams" || arg == "--threads") && i + 1 < argc) {
+            const long value = std::strtol(argv[++i], nullptr, 10);
+            if (value <= 0)
+                return false;
+            std::size_t &target = arg == "--top" ? opts.topK : arg == "--approx" ? opts.approxCapacity
+                                : arg == "--bigrams" ? opts.bigrams : opts.threads;
+            target = static_cast<std::size_t>(value);
+        } else if ((arg == "--serve" || arg == "--socket") && i + 1 < argc) {
+            (arg == "--serve" ? opts.serveHeader : opts.socketPath) = argv[++i];
+        } else if (arg == "--rules" && i + 1 < argc) {
+            opts.rules = argv[++i];
+            if (opts.rules != "ascii" && opts.rules != "alnum" && opts.rules != "hyphen" && opts.rules != "utf8")
+                return false;
+        } else if (arg == "--adaptive") {
+            opts.adaptive = true;
+        } else if (arg == "--adaptive-decode") {
+            opts.adaptiveDecode = true;
+        } else if (opts.fileName.empty() && !arg.starts_with("--")) {
+            opts.fileName = arg;
+        } else {
+            return false;
+        }
+    }
+    if (opts.approxCapacity != 0 && opts.topK == 0)
+        return false;
+    if ((opts.adaptive || opts.adaptiveDecode) && (opts.adaptive == opts.adaptiveDecode || opts.topK != 0 || opts.bigrams != 0))
+        return false;
+    if (!opts.serveHeader.empty())
+        return opts.fileName.empty() && opts.topK == 0 && opts.bigrams == 0 && !opts.adaptive && !opts.adaptiveDecode;
+    if (!opts.socketPath.empty() || opts.threads != 0)
+        return false;
+    return !opts.fileName.empty();
+}
+
+// Calls 'fn' with a scanner over 'inputFileName' built for the rule set named by
+// opts.rules; the choice is made once here, not per byte.
+// pre: opts.rules was validated by parseArgs
+// post: returns whatever 'fn' returns
+template <typename Fn>
+error_type withScanner(const Options &opts, const std::string &inputFileName, Fn &&fn) {
+    if (opts.rules == "alnum") {
+        BasicScanner<AlnumWordRules> scanner(inputFileName);
+        return fn(scanner);
+    }
+    if (opts.rules == "hyphen") {
+        BasicScanner<HyphenWordRules> scanner(inputFileName);
+        return fn(scanner);
+    }
+    if (opts.rules == "utf8") {
+        BasicScanner<Utf8WordRules> scanner(inputFileName);
+        return fn(scanner);
     }
+    Scanner scanner(inputFileName);
+    return fn(scanner);
+}
+
+// Prints the K heaviest words of the scanner's input in .freq format, exactly
+// from a BST or approximately from a fixed-size space-saving counter.
+// pre: opts.topK > 0
+// post: results are written to std::cout; returns NO_ERROR or the scanner's error
+template <typename ScannerT>
+error_type printTopK(ScannerT &scanner, const Options &opts) {
+    if (opts.approxCapacity == 0) {
+        BinSearchTree bst;
+        if (error_type status = scanner.tokenize([&bst](std::string &w) { bst.insert(w); }); status != NO_ERROR)
+            return status;
+        std::vector<std::pair<std::string, std::uint64_t>> top;
+        bst.topK(opts.topK, top);
+        return writeFrequencies(std::cout, top);
+    }
+
+    SpaceSaving counter(opts.approxCapacity);
+    if (error_type status = scanner.tokenize([&counter](std::string &w) { counter.insert(w); }); status != NO_ERROR)
+        return status;
+    std::vector<SpaceSaving::Entry> top;
+    counter.topK(opts.topK, top);
+    for (const auto &e : top)
+        std::cout << std::setw(10) << e.count << ' ' << e.word << "  (overestimate <= " << e.error << ")\n";
+    return std::cout.fail() ? FAILED_TO_WRITE_FILE : NO_ERROR;
+}
 
+// Encodes the scanner's input in one pass with the adaptive Huffman coder;
+// tokens go straight from the scanner to the coder and are never stored.
+// pre: none
+// post: the code is written to 'os'; with 'live' set 'os' is flushed after
+//       every token so a tailing reader sees it immediately
+template <typename ScannerT>
+error_type encodeAdaptive(ScannerT &scanner, bool live, std::ostream &os) {
+    AdaptiveHuffmanEncoder encoder(os, 80);
+    error_type writeStatus = NO_ERROR;
+    const error_type status = scanner.tokenize([&](std::string &w) {
+        if (writeStatus != NO_ERROR)
+            return;
+        writeStatus = encoder.encode(w);
+        if (live)
+            os.flush();
+    });
+    if (status != NO_ERROR)
+        return status;
+    if (writeStatus != NO_ERROR)
+        return writeStatus;
+    return encoder.finish();
+}
+
+// Decodes an adaptive Huffman code back into one token per line (the .tokens format)
+// pre: 'is' holds output of encodeAdaptive
+// post: tokens are written to std::cout; returns the decoder's status
+error_type decodeAdaptive(std::istream &is) {
+    AdaptiveHuffmanDecoder decoder(is);
+    std::string word;
+    while (decoder.next(word))
+        std::cout << word << '\n';
+    std::cout.flush();
+    if (std::cout.fail())
+        return FAILED_TO_WRITE_FILE;
+    return decoder.status();
+}
+
+// Error for an input that failed to open, found without probing on success
+// pre: opening 'fileName' for reading just failed
+// post: FILE_NOT_FOUND if it is not a regular file, else UNABLE_TO_OPEN_FILE
+error_type inputOpenError(const std::string &fileName) {
+    return regularFileExists(fileName) != NO_ERROR ? FILE_NOT_FOUND : UNABLE_TO_OPEN_FILE;
+}
+
+// Opens an output file once, truncating it; the caller writes through 'out'
+// pre: none
+// post: NO_ERROR with 'out' open, DIR_NOT_FOUND if 'dirName' is missing,
+//       otherwise UNABLE_TO_OPEN_FILE_FOR_WRITING. The directory is only
+//       checked after a failed open
+error_type openOutput(std::ofstream &out, const std::string &fileName, const std::string &dirName) {
+    out.open(fileName, std::ios::out | std::ios::trunc);
+    if (out.is_open())
+        return NO_ERROR;
+    if (error_type status = directoryExists(dirName); status != NO_ERROR)
+        return status;
+    return UNABLE_TO_OPEN_FILE_FOR_WRITING;
+}
+
+// Opens the input named on the command line, falling back to input_output/<name>
+// pre: none
+// post: the scanner holds the open input and 'inputFileName' names it; exits
+//       with the error for the given name if neither can be opened
+template <typename ScannerT>
+void openInput(ScannerT &scanner, const std::string &givenName, const std::string &dirName,
+               std::string &inputFileName) {
+    inputFileName = givenName;
+    error_type s = scanner.open(givenName);
+    if (s == NO_ERROR)
+        return;
+    if (s != FILE_NOT_FOUND && s != DIR_NOT_FOUND && s != UNABLE_TO_OPEN_FILE)
+        exitOnError(s, givenName);   // found but unreadable as text: no fallback
+    if (s == DIR_NOT_FOUND)
+        s = FILE_NOT_FOUND;          // a missing input has always been reported as a missing file
+    const std::string alt = dirName + "/" + givenName;
+    if (scanner.open(alt) != NO_ERROR)
+        exitOnError(s, givenName);
+    inputFileName = alt;
+}
+
+// The file modes: top-K, adaptive encoding and the full .tokens/.freq/.hdr/.code
+// pipeline. Every file is opened exactly once and written through that handle.
+// pre: opts.fileName names the input (not "-")
+// post: outputs are written and NO_ERROR is returned; failures found here exit
+//       through exitOnError with the name of the file involved
+template <typename ScannerT>
+error_type runFile(ScannerT &scanner, const Options &opts) {
     const std::string dirName = std::string("input_output");
-    const std::string givenName = std::string(argv[1]);
+    const std::string givenName = opts.fileName;
 
-    std::string inputFileName = givenName;
-    if (error_type s = regularFileExistsAndIsAvailable(inputFileName); s != NO_ERROR) {
-        std::string alt = dirName + "/" + givenName;
-        if (error_type s2 = regularFileExistsAndIsAvailable(alt); s2 != NO_ERROR) {
-            exitOnError(s, givenName);
-        }
-        inputFileName = alt;
+    std::string inputFileName;
+    openInput(scanner, givenName, dirName, inputFileName);
+
+    if (opts.topK > 0) {
+        if (error_type status = printTopK(scanner, opts); status != NO_ERROR)
+            exitOnError(status, inputFileName);
+        return NO_ERROR;
     }
 
     const std::string inputFileBaseName = baseNameWithoutTxt(givenName);
 
+    if (opts.adaptive) {
+        const std::string adaptiveFileName = dirName + "/" + inputFileBaseName + ".acode";
+        std::ofstream out;
+        if (error_type status = openOutput(out, adaptiveFileName, dirName); status != NO_ERROR)
+            exitOnError(status, status == DIR_NOT_FOUND ? dirName : adaptiveFileName);
+        if (error_type status = encodeAdaptive(scanner, false, out); status != NO_ERROR)
+            exitOnError(status, status == FAILED_TO_WRITE_FILE ? adaptiveFileName : inputFileName);
+        return NO_ERROR;
+    }
+
     // build the path to the .tokens output file.
     const std::string wordTokensFileName = dirName + "/" + inputFileBaseName + ".tokens";
 
@@ -41,51 +239,49 @@ int main(int argc, char *argv[]) {
 
     const std::string codeFileName = dirName + "/" + inputFileBaseName + ".code";
 
-    // The next several if-statement make sure that the input file, the directory exist
-    // and that the output file is writeable.
-    if( error_type status; (status = regularFileExistsAndIsAvailable(inputFileName)) != NO_ERROR )
-        exitOnError(status, inputFileName);
-
+    // The input is already open; the .tokens and .freq outputs are opened (and
+    // truncated) here, before any work, and written through these handles later.
+    std::ofstream tokensOut;
+    if (error_type status = openOutput(tokensOut, wordTokensFileName, dirName); status != NO_ERROR)
+        exitOnError(status, status == DIR_NOT_FOUND ? dirName : wordTokensFileName);
 
-    if (error_type status; (status = directoryExists(dirName)) != NO_ERROR )
-        exitOnError(status, dirName);
-
-    if (error_type status; (status = canOpenForWriting(wordTokensFileName)) != NO_ERROR)
-        exitOnError(status, wordTokensFileName);
+    std::ofstream freqOut;
+    if (error_type status = openOutput(freqOut, frequenciesFileName, dirName); status != NO_ERROR)
+        exitOnError(status, status == DIR_NOT_FOUND ? dirName : frequenciesFileName);
 
-    if (error_type status; (status = canOpenForWriting(frequenciesFileName)) != NO_ERROR)
-        exitOnError(status, frequenciesFileName);
-
-
-    std::vector<std::string> words;
-    namespace fs = std::filesystem;
-    Scanner scanner(inputFileName);
-    if (error_type status; (status = scanner.tokenize(words)) != NO_ERROR)
+    // Tokens are interned as they are scanned; everything up to the writers
+    // below works on the dense id array.
+    TokenDictionary dict;
+    std::vector<TokenDictionary::Id> ids;
+    if (error_type status = scanner.tokenize(ids, dict); status != NO_ERROR)
         exitOnError(status,inputFileName);
 
-    if (error_type status; (status = writeVectorToFile(wordTokensFileName, words)) != NO_ERROR)
+    if (error_type status = writeTokens(tokensOut, ids, dict); status != NO_ERROR)
         exitOnError(status, wordTokensFileName);
+    tokensOut.close();
 
-    BinSearchTree bst;
-    bst.bulkInsert(words);
+    std::vector<std::uint64_t> counts = countTokens(ids, dict.size());
 
-    std::vector<std::pair<std::string,int>> frequencies;
-    bst.inorderCollect(frequencies);
+    // Distinct words in first-occurrence order give the same tree as inserting every token.
+    BinSearchTree bst;
+    for (TokenDictionary::Id id = 0; id < dict.size(); id++) {
+        bst.insert(dict.word(id), counts[id]);
+    }
 
     unsigned H = bst.height();
     std::size_t U = bst.size();
-    std::size_t T = words.size();
-    int minF = 0, maxF = 0;
-
-    if (!frequencies.empty()) {
-        minF = frequencies[0].second;
-        maxF = frequencies[0].second;
-        for (std::size_t i = 1; i < frequencies.size(); i++) {
-            if (frequencies[i].second < minF) {
-                minF = frequencies[i].second;
+    std::size_t T = ids.size();
+    std::uint64_t minF = 0, maxF = 0;
+
+    if (!counts.empty()) {
+        minF = counts[0];
+        maxF = counts[0];
+        for (std::size_t i = 1; i < counts.size(); i++) {
+            if (counts[i] < minF) {
+                minF = counts[i];
             }
-            if (frequencies[i].second > maxF) {
-                maxF = frequencies[i].second;
+            if (counts[i] > maxF) {
+                maxF = counts[i];
             }
         }
     } else {
@@ -102,45 +298,53 @@ int main(int argc, char *argv[]) {
     std::cout << "Min frequency: " << minF << "\n";
     std::cout << "Max frequency: " << maxF << "\n";
 
-    std::vector<TreeNode*> leaves;
-    leaves.reserve(frequencies.size());
-    for (std::size_t i = 0; i < frequencies.size(); i++) {
-        const std::string& word = frequencies[i].first;
-        int c = frequencies[i].second;
-        leaves.push_back(new TreeNode(word, c));
+    // Rank once; the same order feeds the .freq listing and the Huffman queue.
+    std::vector<TokenDictionary::Id> ranked = rankIds(counts, dict);
+    if (error_type e = writeFrequencies(freqOut, ranked, counts, dict); e != NO_ERROR) {
+        exitOnError(e, frequenciesFileName);
     }
+    freqOut.close();
 
-    PriorityQueue pq(leaves);
+    // Optional phrase model: .tokens and .freq above stay per word; the header
+    // and code below use words and promoted bigrams. The phrase tree is the one
+    // written out; the word tree is built only for comparison.
+    HuffmanTree ht;
+    if (opts.bigrams > 0) {
+        const std::uint64_t wordBits = HuffmanTree::buildFromIds(ranked, counts, dict).encodedBits();
+        const PhraseModel phrases(ids, dict, opts.bigrams);
+        ids = phrases.segment(ids);
+        counts = countTokens(ids, dict.size());
+        ranked = rankIds(counts, dict);
+        ht = HuffmanTree::buildFromIds(ranked, counts, dict);
+        const std::uint64_t phraseBits = ht.encodedBits();
 
-    std::vector<TreeNode*> extracted;
-    extracted.reserve(pq.size());
-    while (!pq.empty()) {
-        TreeNode* m = pq.extractMin();
-        if (m != nullptr) {
-            extracted.push_back(m);
-        }
-    }
-    {
-        std::ofstream out(frequenciesFileName, std::ios::out | std::ios::trunc);
-        if (!out.is_open()) {
-            exitOnError(UNABLE_TO_OPEN_FILE_FOR_WRITING, frequenciesFileName);
-        }
-
-        for (std::size_t i = extracted.size(); i-- > 0;) {
-            TreeNode* node = extracted[i];
-            out << std:: setw(10) << node ->freq << ' ' << node->keyWord() << '\n';
-        }
-    }
-
-    for (std::size_t i = 0; i < extracted.size(); i++) {
-        delete extracted[i];
+        // Only the .code stream is compared; the .hdr grows by one line per phrase.
+        const double gain = wordBits == 0 ? 0.0 : 100.0 * (1.0 - static_cast<double>(phraseBits) / static_cast<double>(wordBits));
+        std::cout << "Bigram phrases: " << phrases.size() << "\n";
+        std::cout << "Word model code bits: " << wordBits << "\n";
+        std::cout << "Phrase model code bits: " << phraseBits << "\n";
+        std::cout << "Code bits gain (.code only, excludes .hdr): " << std::fixed << std::setprecision(2) << gain << "%\n";
+    } else {
+        ht = HuffmanTree::buildFromIds(ranked, counts, dict);
     }
 
-    for (std::size_t i = 0; i < leaves.size(); i++) {
-        leaves[i] = nullptr;
+    // Code quality of the tree that is written below.
+    const CodeStats stats = ht.codeStats();
+    std::cout << "Huffman symbols: " << stats.symbols << "\n";
+    std::cout << "Encoded bits: " << stats.totalBits << "\n";
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "Average code length: " << stats.averageLength << " bits\n";
+    std::cout << "Entropy: " << stats.entropy << " bits\n";
+    std::cout << std::setprecision(2);
+    std::cout << "Code efficiency: " << (stats.averageLength > 0.0 ? 100.0 * stats.entropy / stats.averageLength : 0.0) << "%\n";
+    std::cout << "Min code length: " << stats.minLength << "\n";
+    std::cout << "Max code length: " << stats.maxLength << "\n";
+    std::cout << "Code length histogram:";
+    for (std::size_t length = 1; length < stats.lengthHistogram.size(); length++) {
+        if (stats.lengthHistogram[length] != 0)
+            std::cout << ' ' << length << ':' << stats.lengthHistogram[length];
     }
-
-    HuffmanTree ht = HuffmanTree::buildFromCounts(frequencies);
+    std::cout << "\n";
     {
         std::ofstream hdr(headerFileName, std::ios::out | std::ios::trunc);
         if (!hdr.is_open()) exitOnError(UNABLE_TO_OPEN_FILE_FOR_WRITING, headerFileName);
@@ -151,10 +355,74 @@ int main(int argc, char *argv[]) {
     {
         std::ofstream code(codeFileName, std::ios::out | std::ios::trunc);
         if (!code.is_open()) exitOnError(UNABLE_TO_OPEN_FILE_FOR_WRITING, codeFileName);
-        if (error_type e = ht.encode(words, code, 80); e != NO_ERROR) {
+        if (error_type e = ht.encode(ids, code, 80); e != NO_ERROR) {
             exitOnError(e, codeFileName);
         }
     }
+    return NO_ERROR;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    Options opts;
+    if (!parseArgs(argc, argv, opts)) {
+        std::cerr << "Usage: " << argv[0] << " [--rules ascii|alnum|hyphen|utf8] [--bigrams N] [--top K [--approx N]] [--adaptive | --adaptive-decode] <filename>\n"
+                  << "       " << argv[0] << " [--rules ascii|alnum|hyphen|utf8] --serve <file.hdr> [--socket PATH] [--threads N]\n";
+        return 1;
+    }
+
+    // Server mode: the codebook is loaded once and stays resident for every request.
+    if (!opts.serveHeader.empty()) {
+        CodecServer server(opts.rules, opts.threads);
+        if (error_type status = server.load(opts.serveHeader); status != NO_ERROR) {
+            if (status != FILE_NOT_FOUND || server.load("input_output/" + opts.serveHeader) != NO_ERROR)
+                exitOnError(status, opts.serveHeader);
+        }
+        if (opts.socketPath.empty()) {
+            server.serveStream(0, 1);
+            return 0;
+        }
+        exitOnError(server.serveSocket(opts.socketPath), opts.socketPath);
+        return 0;
+    }
+
+    // Standard input is read as it arrives; the adaptive modes write to standard output.
+    if (opts.fileName == "-") {
+        if (opts.adaptiveDecode) {
+            if (error_type status = decodeAdaptive(std::cin); status != NO_ERROR)
+                exitOnError(status, opts.fileName);
+            return 0;
+        }
+        if (!opts.adaptive) {
+            std::cerr << "Standard input (-) is only supported with --adaptive or --adaptive-decode\n";
+            return 1;
+        }
+        if (error_type status = withScanner(opts, opts.fileName, [](auto &scanner) {
+                return encodeAdaptive(scanner, true, std::cout);
+            }); status != NO_ERROR)
+            exitOnError(status, opts.fileName);
+        return 0;
+    }
+
+    if (opts.adaptiveDecode) {
+        std::string inputFileName = opts.fileName;
+        std::ifstream in(inputFileName);
+        if (!in.is_open()) {
+            const error_type s = inputOpenError(inputFileName);
+            inputFileName = "input_output/" + opts.fileName;
+            in.open(inputFileName);
+            if (!in.is_open())
+                exitOnError(s, opts.fileName);
+        }
+        if (error_type status = decodeAdaptive(in); status != NO_ERROR)
+            exitOnError(status, inputFileName);
+        return 0;
+    }
 
+    if (error_type status = withScanner(opts, opts.fileName, [&opts](auto &scanner) {
+            return runFile(scanner, opts);
+        }); status != NO_ERROR)
+        exitOnError(status, opts.fileName);
     return 0;
 }
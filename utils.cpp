@@ -31,6 +31,26 @@ void exitOnError(error_type error, const std::string &entityName = "") {
             std::cerr << "Error: Unable to open " << entityName << " for writing. Terminating...\n";
             exit(UNABLE_TO_OPEN_FILE_FOR_WRITING);
 
+        case FAILED_TO_READ_FILE:
+            std::cerr << "Error: Failed while reading " << entityName << ". Terminating...\n";
+            exit(FAILED_TO_READ_FILE);
+
+        case UNSUPPORTED_FILE_FORMAT:
+            std::cerr << "Error: Unsupported compression format in " << entityName << ". Terminating...\n";
+            exit(UNSUPPORTED_FILE_FORMAT);
+
+        case MALFORMED_CODE:
+            std::cerr << "Error: " << entityName << " is not a valid code stream. Terminating...\n";
+            exit(MALFORMED_CODE);
+
+        case FAILED_TO_ACCEPT_CONNECTION:
+            std::cerr << "Error: Stopped accepting connections on " << entityName << ". Terminating...\n";
+            exit(FAILED_TO_ACCEPT_CONNECTION);
+
+        case INSUFFICIENT_MEMORY:
+            std::cerr << "Error: Not enough memory to read " << entityName << ". Terminating...\n";
+            exit(INSUFFICIENT_MEMORY);
+
         default:
             std::cerr << "Error: Unknown error type. Terminating...\n";
             exit(ERR_TYPE_NOT_FOUND);
@@ -72,11 +92,14 @@ error_type regularFileExistsAndIsAvailable(const std::string &filename) {
 
 
 std::string baseNameWithoutTxt(const std::string& filename) {
-    // "filename" is expected to have .txt extension.
-    // Return the base-name of the "filename".
+    // "filename" is expected to have .txt extension, optionally followed by a
+    // compression suffix (.gz, .zst). Return the base-name of the "filename".
 
     namespace fs = std::filesystem;
     fs::path p(filename);
+    if (p.extension() == ".gz" || p.extension() == ".zst") {
+        p = p.parent_path() / p.stem();
+    }
 
     // stem() gives filename without extension
     if (p.extension() == ".txt") {
@@ -17,6 +17,11 @@ enum error_type {
     ERR_TYPE_NOT_FOUND,
     UNABLE_TO_OPEN_FILE_FOR_WRITING,
     FAILED_TO_WRITE_FILE,
+    FAILED_TO_READ_FILE,
+    UNSUPPORTED_FILE_FORMAT,
+    MALFORMED_CODE,
+    FAILED_TO_ACCEPT_CONNECTION,
+    INSUFFICIENT_MEMORY,
 };
 
 void exitOnError(error_type error, const std::string& entityName);